@@ -0,0 +1,189 @@
+/*
+ * AllocStats.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Replacement global operator new/delete that count allocations.
+ */
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "AllocStats.h"
+
+using namespace std;
+
+namespace {
+
+thread_local uint64_t allocations = 0;
+
+/*
+ * @function: counted_alloc
+ * @purpose: Allocates memory for operator new and counts the call.
+ *
+ * @preconditions: 'alignment' is zero or a power of two.
+ *
+ * @postconditions: The calling thread's count is one higher.
+ *
+ * @parameters: size - Bytes wanted (size_t), alignment - Alignment
+ * wanted, or zero for the default (size_t).
+ *
+ * @returns: The memory, or nullptr if there is none (void*).
+ */
+
+void *counted_alloc(size_t size, size_t alignment)
+{
+    allocations++;
+    if (size == 0) {
+        size = 1;
+    }
+    if (alignment <= alignof(max_align_t)) {
+        return malloc(size);
+    }
+    void *p = nullptr;
+    if (posix_memalign(&p, alignment, size) != 0) {
+        return nullptr;
+    }
+    return p;
+}
+
+/*
+ * @function: checked_alloc
+ * @purpose: Allocates memory for the throwing forms of operator new,
+ * calling the new-handler until it succeeds, as the standard one does.
+ *
+ * @preconditions: 'alignment' is zero or a power of two.
+ *
+ * @postconditions: The calling thread's count is higher by one per
+ * attempt.
+ *
+ * @parameters: size - Bytes wanted (size_t), alignment - Alignment
+ * wanted, or zero for the default (size_t).
+ *
+ * @returns: The memory (void*). Throws bad_alloc if there is none and
+ * no new-handler is installed.
+ */
+
+void *checked_alloc(size_t size, size_t alignment)
+{
+    void *p = counted_alloc(size, alignment);
+    while (p == nullptr) {
+        new_handler handler = get_new_handler();
+        if (handler == nullptr) {
+            throw bad_alloc();
+        }
+        handler();
+        p = counted_alloc(size, alignment);
+    }
+    return p;
+}
+
+}
+
+/*
+ * @function: allocation_count
+ * @purpose: Reports how many times the calling thread has called
+ * operator new.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: The number of allocations (uint64_t).
+ */
+
+uint64_t allocation_count()
+{
+    return allocations;
+}
+
+/*
+ * @function: allocation_counting
+ * @purpose: Reports whether this build counts allocations.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: True (bool).
+ */
+
+bool allocation_counting()
+{
+    return true;
+}
+
+void *operator new(size_t size)
+{
+    return checked_alloc(size, 0);
+}
+
+void *operator new[](size_t size)
+{
+    return checked_alloc(size, 0);
+}
+
+void *operator new(size_t size, align_val_t alignment)
+{
+    return checked_alloc(size, static_cast<size_t>(alignment));
+}
+
+void *operator new[](size_t size, align_val_t alignment)
+{
+    return checked_alloc(size, static_cast<size_t>(alignment));
+}
+
+void *operator new(size_t size, const nothrow_t &) noexcept
+{
+    try {
+        return checked_alloc(size, 0);
+    } catch (const bad_alloc &) {
+        return nullptr;
+    }
+}
+
+void *operator new[](size_t size, const nothrow_t &) noexcept
+{
+    try {
+        return checked_alloc(size, 0);
+    } catch (const bad_alloc &) {
+        return nullptr;
+    }
+}
+
+void *operator new(size_t size, align_val_t alignment,
+                   const nothrow_t &) noexcept
+{
+    try {
+        return checked_alloc(size, static_cast<size_t>(alignment));
+    } catch (const bad_alloc &) {
+        return nullptr;
+    }
+}
+
+void *operator new[](size_t size, align_val_t alignment,
+                     const nothrow_t &) noexcept
+{
+    try {
+        return checked_alloc(size, static_cast<size_t>(alignment));
+    } catch (const bad_alloc &) {
+        return nullptr;
+    }
+}
+
+void operator delete(void *p) noexcept                  { free(p); }
+void operator delete[](void *p) noexcept                { free(p); }
+void operator delete(void *p, size_t) noexcept          { free(p); }
+void operator delete[](void *p, size_t) noexcept        { free(p); }
+void operator delete(void *p, align_val_t) noexcept     { free(p); }
+void operator delete[](void *p, align_val_t) noexcept   { free(p); }
+void operator delete(void *p, size_t, align_val_t) noexcept   { free(p); }
+void operator delete[](void *p, size_t, align_val_t) noexcept { free(p); }
+void operator delete(void *p, const nothrow_t &) noexcept     { free(p); }
+void operator delete[](void *p, const nothrow_t &) noexcept   { free(p); }
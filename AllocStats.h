@@ -0,0 +1,25 @@
+/*
+ * AllocStats.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Counts heap allocations. Linking AllocStats.o replaces the global
+ *   operator new with one that bumps a per-thread counter, so the cost
+ *   of a piece of code can be measured as the difference between two
+ *   readings of allocation_count(). Only "make ALLOC_STATS=1" links
+ *   it; other builds link NoAllocStats.o, which keeps the standard
+ *   operator new and counts nothing.
+ */
+#ifndef __ALLOC_STATS__
+#define __ALLOC_STATS__
+
+#include <cstdint>
+
+/* calls to operator new made so far by the calling thread */
+uint64_t allocation_count();
+
+/* whether this build counts allocations at all */
+bool allocation_counting();
+
+#endif /* __ALLOC_STATS__ */
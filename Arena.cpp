@@ -0,0 +1,214 @@
+/*
+ * Arena.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   A monotonic allocator that can be reset or released in one shot.
+ */
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <new>
+#include <string_view>
+#include <vector>
+
+#include "Arena.h"
+
+using namespace std;
+
+/*
+ * @constructor: Arena
+ * @purpose: Constructs an empty arena.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: No memory is reserved until the first allocation.
+ *
+ * @parameters: firstChunk - The size of the first chunk in bytes;
+ * later chunks double in size (size_t).
+ *
+ * @returns: None.
+ */
+
+Arena::Arena(size_t firstChunk)
+    : current(0), used(0), usedBefore(0), firstChunk(firstChunk)
+{
+
+}
+
+/*
+ * @destructor: Arena
+ * @purpose: Frees every chunk.
+ */
+
+Arena::~Arena()
+{
+    release();
+}
+
+/*
+ * @function: reset
+ * @purpose: Forgets every allocation but keeps the chunks, so the
+ * next round of allocations reuses them without touching the heap.
+ *
+ * @preconditions: Nothing allocated from the arena is used again.
+ *
+ * @postconditions: The arena is empty.
+ *
+ * @parameters: None.
+ *
+ * @returns: None.
+ */
+
+void Arena::reset()
+{
+    current    = 0;
+    used       = 0;
+    usedBefore = 0;
+}
+
+/*
+ * @function: release
+ * @purpose: Frees every chunk at once.
+ *
+ * @preconditions: Nothing allocated from the arena is used again.
+ *
+ * @postconditions: The arena is empty and holds no memory.
+ *
+ * @parameters: None.
+ *
+ * @returns: None.
+ */
+
+void Arena::release()
+{
+    for (Chunk &chunk : chunks) {
+        ::operator delete(chunk.data);
+    }
+    chunks.clear();
+    reset();
+}
+
+/*
+ * @function: copy_string
+ * @purpose: Copies text into the arena.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: The copy lives until the arena is reset or
+ * released.
+ *
+ * @parameters: text - The text to copy (string_view).
+ *
+ * @returns: A view of the copy (string_view).
+ */
+
+string_view Arena::copy_string(string_view text)
+{
+    if (text.empty()) {
+        return string_view();
+    }
+    char *copy = static_cast<char *>(allocate(text.size(), 1));
+    memcpy(copy, text.data(), text.size());
+    return string_view(copy, text.size());
+}
+
+/*
+ * @function: bytes_used / bytes_reserved
+ * @purpose: Report how much of the arena is handed out, and how much
+ * memory it holds.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: A byte count (size_t).
+ */
+
+size_t Arena::bytes_used() const
+{
+    return usedBefore + used;
+}
+
+size_t Arena::bytes_reserved() const
+{
+    size_t total = 0;
+    for (const Chunk &chunk : chunks) {
+        total += chunk.size;
+    }
+    return total;
+}
+
+/*
+ * @function: do_allocate
+ * @purpose: Bumps the current chunk, moving to the next (or a new,
+ * larger) chunk when it is full.
+ *
+ * @preconditions: 'alignment' is a power of two.
+ *
+ * @postconditions: The memory lives until the arena is reset or
+ * released.
+ *
+ * @parameters: bytes - The size wanted (size_t), alignment - Its
+ * alignment (size_t).
+ *
+ * @returns: The memory (void*).
+ */
+
+void *Arena::do_allocate(size_t bytes, size_t alignment)
+{
+    for (;;) {
+        if (current < chunks.size()) {
+            Chunk &chunk = chunks[current];
+            uintptr_t base = reinterpret_cast<uintptr_t>(chunk.data);
+            uintptr_t mask = alignment - 1;
+            size_t start = ((base + used + mask) & ~mask) - base;
+            if (start + bytes <= chunk.size) {
+                used = start + bytes;
+                return chunk.data + start;
+            }
+            if (current + 1 < chunks.size()) {
+                usedBefore += used;
+                used = 0;
+                current++;
+                continue;
+            }
+        }
+
+        size_t size = chunks.empty() ? firstChunk : chunks.back().size * 2;
+        while (size < bytes + alignment) {
+            size *= 2;
+        }
+        chunks.push_back(Chunk { static_cast<char *>(::operator new(size)),
+                                 size });
+        usedBefore += used;
+        used = 0;
+        current = chunks.size() - 1;
+    }
+}
+
+/*
+ * @function: do_deallocate
+ * @purpose: Does nothing; memory comes back when the arena is reset
+ * or released.
+ */
+
+void Arena::do_deallocate(void *, size_t, size_t)
+{
+
+}
+
+/*
+ * @function: do_is_equal
+ * @purpose: Two arenas can only free each other's memory if they are
+ * the same arena.
+ */
+
+bool Arena::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
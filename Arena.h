@@ -0,0 +1,60 @@
+/*
+ * Arena.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   A monotonic (bump) allocator. Memory is handed out from large
+ *   chunks and never returned one object at a time; instead the whole
+ *   arena is either reset, which keeps the chunks for reuse, or
+ *   released, which frees them all at once. It is a
+ *   std::pmr::memory_resource, so standard containers can live in it.
+ *
+ *   Graphs keep their build-time data in an arena that is dropped in
+ *   one shot when the graph goes away, and each traversal workspace
+ *   owns a scratch arena that is reset at the start of every query, so
+ *   a warmed-up query does not touch the heap.
+ */
+#ifndef __ARENA__
+#define __ARENA__
+
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+class Arena : public std::pmr::memory_resource {
+    public:
+        explicit Arena(size_t firstChunk = 64 * 1024);
+        ~Arena();
+
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        void reset();
+        void release();
+
+        std::string_view copy_string(std::string_view text);
+
+        size_t bytes_used() const;
+        size_t bytes_reserved() const;
+
+    private:
+        struct Chunk {
+            char  *data;
+            size_t size;
+        };
+
+        void *do_allocate(size_t bytes, size_t alignment) override;
+        void  do_deallocate(void *p, size_t bytes, size_t alignment) override;
+        bool  do_is_equal(const std::pmr::memory_resource &other)
+                                              const noexcept override;
+
+        std::vector<Chunk> chunks;
+        size_t current;
+        size_t used;
+        size_t usedBefore;
+        size_t firstChunk;
+};
+
+#endif /* __ARENA__ */
@@ -107,15 +107,33 @@ void Artist::set_name(const std::string &n)
  * @postconditions: none
  *
  * @parameters: none
- * @returns: a std::string, the name of this Artist instance 
+ * @returns: a const reference to the name of this Artist instance 
  */
-std::string Artist::get_name() const
+const std::string &Artist::get_name() const
 {
     return name;
 }
 
 
 
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * @function: get_discography
+ * @purpose: retrieve the songs of this Artist instance without copying them
+ *
+ * @preconditions: none
+ * @postconditions: none
+ *
+ * @parameters: none
+ * @returns: a const reference to the songs of this Artist instance, in the
+ *           order they were added
+ */
+const std::vector<std::string> &Artist::get_discography() const
+{
+    return discography;
+}
+
+
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  * @function: in_song
  * @purpose: determine whether this Artist instance collaborated in
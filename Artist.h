@@ -44,7 +44,8 @@ public:
     void set_name(const std::string &name);
 
     /* Accessors */
-    std::string get_name() const;
+    const std::string &get_name() const;
+    const std::vector<std::string> &get_discography() const;
     bool        in_song(const std::string &song) const;
     std::string get_collaboration(const Artist &artist) const;
     
@@ -36,9 +36,18 @@
 #include <sstream>
 #include <fstream>
 #include <memory>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <thread>
+#include <algorithm>
 
 #include "Artist.h"
 #include "CollabGraph.h"
+#include "Arena.h"
+#include "Parallel.h"
 
 using namespace std;
 
@@ -73,7 +82,7 @@ CollabGraph::CollabGraph()
  *                  instace is freed
  */
 CollabGraph::~CollabGraph() {
-    graph.clear();
+    self_destruct();
 }
 
 
@@ -107,13 +116,26 @@ CollabGraph &CollabGraph::operator=(const CollabGraph &rhs) {
         self_destruct();
 
         for (auto &pair : rhs.graph) {
-            std::unique_ptr<Vertex> vertexCopy = std::make_unique<Vertex>();
-            vertexCopy->artist = pair.second->artist;
-            vertexCopy->neighbors = pair.second->neighbors;
+            Vertex *vertexCopy = new_vertex(pair.second->artist);
             vertexCopy->predecessor = nullptr;  
             vertexCopy->visited = false;       
 
-            graph[pair.first] = std::move(vertexCopy);
+            graph[pair.first] = vertexCopy;
+        }
+
+        /* edges point at rhs's vertices and songs, so remap them */
+        for (auto &pair : rhs.graph) {
+            Vertex *vertexCopy = graph.at(pair.first);
+            vertexCopy->neighbors.reserve(pair.second->neighbors.size());
+            for (const Edge &edge : pair.second->neighbors) {
+                vertexCopy->neighbors.push_back(
+                    Edge(graph.at(edge.neighbor->artist.get_name()),
+                         intern_song(edge.song)));
+            }
+        }
+
+        for (Vertex *vertex : rhs.insertionOrder) {
+            insertionOrder.push_back(graph.at(vertex->artist.get_name()));
         }
     }
     return *this;
@@ -147,7 +169,9 @@ void CollabGraph::insert_vertex(const Artist &artist) {
 
     if (graph.find(artist.get_name()) == graph.end()) {
 
-        graph[artist.get_name()] = std::make_unique<Vertex>(artist);
+        Vertex *vertex = new_vertex(artist);
+        graph[artist.get_name()] = vertex;
+        insertionOrder.push_back(vertex);
     }
 }
 
@@ -198,8 +222,63 @@ void CollabGraph::insert_edge(const Artist &a1, const Artist &a2,
 
     if (get_edge(a1, a2) != "") return;
 
-    graph.at(a1.get_name())->neighbors.push_back(Edge(a2, edgeName));
-    graph.at(a2.get_name())->neighbors.push_back(Edge(a1, edgeName));
+    Vertex *v1 = graph.at(a1.get_name());
+    Vertex *v2 = graph.at(a2.get_name());
+    string_view song = intern_song(edgeName);
+    v1->neighbors.push_back(Edge(v2, song));
+    v2->neighbors.push_back(Edge(v1, song));
+}
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * insert_edges
+ * purpose: add every edge of a prebuilt adjacency at once, filling the
+ *          neighbor lists on several threads
+ *
+ * preconditions: every artist is already a vertex, no vertex has any
+ *                edges yet, and 'edges' came from buildCollabEdges
+ *                on 'artists'
+ * postconditions: the neighbor list of artists[i] holds the edges of
+ *                 list i of 'edges', in order; this is the graph
+ *                 insert_edge would build from the same collaborations
+ *
+ * parameters: the artists, the adjacency (whose neighbor indices refer
+ *             to 'artists'), and how many threads to use
+ * returns: none
+ */
+void CollabGraph::insert_edges(const vector<Artist *> &artists,
+                               const CollabEdges &edges, size_t threads)
+{
+    /* the lists are sized and the songs pooled up front, so the arena
+     * is only touched on this thread and the fill below never
+     * reallocates */
+    vector<Vertex *> vertices(artists.size());
+    for (size_t i = 0; i < artists.size(); i++) {
+        enforce_valid_vertex(*artists[i]);
+        vertices[i] = graph.at(artists[i]->get_name());
+        vertices[i]->neighbors.reserve(edges.offsets[i + 1] -
+                                       edges.offsets[i]);
+    }
+
+    /* many edges share one discography entry, so look each up once */
+    unordered_map<const string *, string_view> pooled;
+    for (const string *song : edges.songs) {
+        if (pooled.find(song) == pooled.end()) {
+            pooled.emplace(song, intern_song(*song));
+        }
+    }
+
+    parallel_ranges(artists.size(), threads,
+                    [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; i++) {
+            for (size_t e = edges.offsets[i]; e < edges.offsets[i + 1]; e++) {
+                vertices[i]->neighbors.push_back(
+                    Edge(vertices[edges.neighbors[e]],
+                         pooled.at(edges.songs[e])));
+            }
+        }
+    });
 }
 
 
@@ -255,11 +334,11 @@ void CollabGraph::set_predecessor(const Artist &to, const Artist &from) {
     enforce_valid_vertex(to);
     enforce_valid_vertex(from);
 
-    auto& to_vertex = graph.at(to.get_name());
-    auto& from_vertex = graph.at(from.get_name());
+    Vertex *to_vertex = graph.at(to.get_name());
+    Vertex *from_vertex = graph.at(from.get_name());
 
     if (to_vertex->predecessor == nullptr) {
-        to_vertex->predecessor = from_vertex.get();
+        to_vertex->predecessor = from_vertex;
     }
 }
 
@@ -363,18 +442,18 @@ string CollabGraph::get_edge(const Artist &a1, const Artist &a2) const
     enforce_valid_vertex(a1);
     enforce_valid_vertex(a2);
 
-    vector<Edge> adj = graph.at(a1.get_name())->neighbors;
+    const pmr::vector<Edge> &adj = graph.at(a1.get_name())->neighbors;
 
     size_t idx = 0;
     bool found = false;
     while (not found and idx < adj.size()) {
-        if (adj[idx].neighbor == a2) {
+        if (adj[idx].neighbor->artist == a2) {
             found = true;
         }
         else idx++;
     }
 
-    if (idx < adj.size()) return adj[idx].song;
+    if (idx < adj.size()) return string(adj[idx].song);
     else                  return "";
 }
 
@@ -394,10 +473,10 @@ vector<Artist> CollabGraph::get_vertex_neighbors(const Artist &artist) const
 
     enforce_valid_vertex(artist);
 
-    const vector<Edge> &edges = graph.at(artist.get_name())->neighbors;
+    const pmr::vector<Edge> &edges = graph.at(artist.get_name())->neighbors;
 
     for (const Edge &edge : edges) {
-        neighbors.push_back(edge.neighbor);
+        neighbors.push_back(edge.neighbor->artist);
     }
 
     return neighbors;
@@ -458,26 +537,110 @@ stack<Artist> CollabGraph::report_path(const Artist& source, const Artist& dest)
  * purpose: print a representation of the information stored in the
  *          collaboration graph
  *
+ * notes: formats one vertex at a time on the calling thread; see
+ *        print_graph_parallel for the threaded version
+ *
  * parameters: a ostream reference, where output is sent
  * returns: none
  */
 void CollabGraph::print_graph(ostream &out)
 {
+    string text;
     for (auto itr = graph.begin(); itr != graph.end(); itr++) {
+        text.clear();
+        append_lines(*itr->second, text);
+        out.write(text.data(), text.size());
+    }
+    out.flush();
+}
 
-        vector<Edge> neighbors = itr->second->neighbors;
 
-        for (size_t i = 0; i < neighbors.size(); i++) {
-            out << "\"" << itr->second->artist.get_name() << "\" "
-                << "collaborated with "
-                << "\"" << neighbors.at(i).neighbor << "\" in "
-                << "\"" << neighbors.at(i).song << "\"."
-                << endl;
-        }
 
-        out << "***" << endl;
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * function: print_graph_parallel
+ * purpose: print what print_graph does, formatting it on several
+ *          threads
+ *
+ * postconditions: every vertex, in the order of the map, has printed
+ *                 one line per edge and then "***"; the text is the
+ *                 same for any number of threads. Vertices are cut
+ *                 into pieces of about PRINT_PIECE_LINES lines, each
+ *                 thread formats one piece of a round into its own
+ *                 buffer, and a writer thread sends the previous
+ *                 round to 'out' in order meanwhile, so at most two
+ *                 rounds are held at once. One thread prints with
+ *                 print_graph, with no writer thread
+ *
+ * parameters: a ostream reference, where output is sent, and how many
+ *             threads format the text
+ * returns: none
+ */
+void CollabGraph::print_graph_parallel(ostream &out, size_t threads)
+{
+    const size_t PRINT_PIECE_LINES = 16384;
+    if (threads <= 1) {
+        print_graph(out);
+        return;
+    }
+
+    vector<const Vertex *> order;
+    order.reserve(graph.size());
+    for (auto itr = graph.begin(); itr != graph.end(); itr++) {
+        order.push_back(itr->second);
     }
 
+    /* piece p is order[cuts[p], cuts[p + 1]) */
+    vector<size_t> cuts(1, 0);
+    size_t lines = 0;
+    for (size_t i = 0; i < order.size(); i++) {
+        lines += order[i]->neighbors.size() + 1;
+        if (lines >= PRINT_PIECE_LINES or i + 1 == order.size()) {
+            cuts.push_back(i + 1);
+            lines = 0;
+        }
+    }
+    size_t pieces = cuts.size() - 1;
+
+    vector<string> formatting(threads), writing(threads);
+    thread writer;
+
+    /* a round that throws must not leave the writer joinable, or its
+     * destructor terminates the program */
+    try {
+        for (size_t first = 0; first < pieces; first += threads) {
+            size_t round = min(threads, pieces - first);
+            parallel_ranges(round, round, [&](size_t begin, size_t end,
+                                              size_t) {
+                for (size_t p = begin; p < end; p++) {
+                    string &text = formatting[p];
+                    text.clear();
+                    for (size_t i = cuts[first + p]; i < cuts[first + p + 1];
+                         i++) {
+                        append_lines(*order[i], text);
+                    }
+                }
+            });
+
+            if (writer.joinable()) {
+                writer.join();
+            }
+            formatting.swap(writing);
+            writer = thread([&out, &writing, round] {
+                for (size_t p = 0; p < round; p++) {
+                    out.write(writing[p].data(), writing[p].size());
+                }
+            });
+        }
+    } catch (...) {
+        if (writer.joinable()) {
+            writer.join();
+        }
+        throw;
+    }
+    if (writer.joinable()) {
+        writer.join();
+    }
+    out.flush();
 }
 
 
@@ -499,7 +662,108 @@ void CollabGraph::print_graph(ostream &out)
  * returns: none
  */
 void CollabGraph::self_destruct() {
-    graph.clear(); // Automatically deletes managed objects
+    /* vertices live in the arena, so destroy them and then free the
+     * arena (and every neighbor list in it) in one go */
+    for (auto &pair : graph) {
+        pair.second->~Vertex();
+    }
+    graph.clear();
+    insertionOrder.clear();
+    songPool.clear();
+    vertexArena.release();
+}
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * memory_usage
+ * purpose: estimate how much memory this CollabGraph instance holds
+ *
+ * parameters: none
+ * returns: the bytes held by the vertex arena (which also holds the
+ *          song titles), the hash tables and the artist names
+ */
+size_t CollabGraph::memory_usage() const {
+    /* strings that do not fit in the small-string buffer are on the heap */
+    auto string_bytes = [](const string &text) {
+        return text.capacity() > string().capacity() ? text.capacity() + 1
+                                                     : 0;
+    };
+
+    /* each hash node holds a key, a value, a next pointer and a hash */
+    size_t total = vertexArena.bytes_reserved() +
+                   graph.bucket_count() * sizeof(void *) +
+                   graph.size() * (sizeof(pair<const string, Vertex *>) +
+                                   2 * sizeof(void *)) +
+                   songPool.bucket_count() * sizeof(void *) +
+                   songPool.size() * (sizeof(string_view) +
+                                      2 * sizeof(void *));
+    for (const auto &pair : graph) {
+        total += string_bytes(pair.first);
+        total += string_bytes(pair.second->artist.get_name());
+    }
+    return total;
+}
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * new_vertex
+ * purpose: create a vertex in the arena of this CollabGraph instance
+ *
+ * parameters: a const Artist reference, the artist the vertex represents
+ * returns: a pointer to the new vertex, whose neighbor list also lives
+ *          in the arena; it is destroyed by self_destruct
+ *
+ * notes: the vertex keeps only the artist's name; the discography
+ *        stays with the caller's Artist, which may go once the graph
+ *        is built
+ */
+CollabGraph::Vertex *CollabGraph::new_vertex(const Artist &artist) {
+    void *memory = vertexArena.allocate(sizeof(Vertex), alignof(Vertex));
+    return new (memory) Vertex(Artist(artist.get_name()), &vertexArena);
+}
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * intern_song
+ * purpose: find a song title in the pool of this CollabGraph instance,
+ *          adding it if it is not there yet
+ *
+ * parameters: the title
+ * returns: a view of the pooled copy, which lives in the arena until
+ *          self_destruct
+ */
+string_view CollabGraph::intern_song(string_view song) {
+    auto pooled = songPool.find(song);
+    if (pooled == songPool.end()) {
+        pooled = songPool.insert(vertexArena.copy_string(song)).first;
+    }
+    return *pooled;
+}
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * append_lines
+ * purpose: format what print_graph prints for one vertex
+ *
+ * parameters: the vertex, and the text its lines are appended to
+ * returns: none
+ */
+void CollabGraph::append_lines(const Vertex &vertex, string &text) {
+    const string &name = vertex.artist.get_name();
+    for (const Edge &edge : vertex.neighbors) {
+        text += '"';
+        text += name;
+        text += "\" collaborated with \"";
+        text += edge.neighbor->artist.get_name();
+        text += "\" in \"";
+        text += edge.song;
+        text += "\".\n";
+    }
+    text += "***\n";
 }
 
 
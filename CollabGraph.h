@@ -29,9 +29,15 @@
 #include <stack>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+#include <string>
+#include <string_view>
 #include <memory>
+#include <memory_resource>
 
 #include "Artist.h"
+#include "Arena.h"
+#include "EdgeBuilder.h"
 
 class CollabGraph {
 
@@ -60,6 +66,10 @@ public:
     void set_predecessor(const Artist &to, const Artist &from);
     void clear_metadata();    
 
+    /* adds prebuilt adjacency lists, see EdgeBuilder.h */
+    void insert_edges(const std::vector<Artist *> &artists,
+                      const CollabEdges &edges, size_t threads);
+
     /* Accessors */
     bool                is_vertex(const Artist &artist) const;
     bool                is_marked(const Artist &artist) const;
@@ -74,22 +84,32 @@ public:
 
     void                print_graph(std::ostream &out);
 
+    /* print_graph's text, formatted on 'threads' threads and written
+     * in order */
+    void                print_graph_parallel(std::ostream &out,
+                                             size_t threads);
+
+    /* heap and arena bytes held by the graph, for --profile-load */
+    size_t              memory_usage() const;
+
 private:
+    struct Vertex;
+
+    /* an edge names its collaborator by vertex and its song by a view
+     * into songPool, so no name or title is copied per edge */
     struct Edge {
-        Edge(Artist a, std::string s) {
-            neighbor = a; 
-            song = s; 
-        };
-        Artist neighbor;
-        std::string song;
+        Edge(const Vertex *n, std::string_view s)
+            : neighbor(n), song(s) {};
+        const Vertex *neighbor;
+        std::string_view song;
     };
 
     struct Vertex {
-        Vertex() {};
-        Vertex(Artist a) { artist = a; };
+        Vertex(const Artist &a, std::pmr::memory_resource *arena)
+            : artist(a), neighbors(arena) {};
 
-        Artist artist;
-        std::vector<Edge> neighbors;
+        Artist artist;             /* the name only, no discography */
+        std::pmr::vector<Edge> neighbors;
 
         Vertex *predecessor = nullptr;
         bool visited = false;
@@ -97,8 +117,24 @@ private:
 
     void self_destruct();
     void enforce_valid_vertex(const Artist &artist) const;
+    Vertex *new_vertex(const Artist &artist);
+    std::string_view intern_song(std::string_view song);
+    static void append_lines(const Vertex &vertex, std::string &text);
+
+    /* vertices and their neighbor lists are carved out of one arena
+     * instead of one heap allocation each; it is freed all at once */
+    Arena vertexArena;
+    std::unordered_map<std::string, Vertex *> graph;
+
+    /* every song title once, its bytes in the arena; the discographies
+     * the graph was built from are not needed once it is */
+    std::unordered_set<std::string_view> songPool;
+
+    /* vertices in the order they were inserted; CompactGraph numbers
+     * vertices in this order so traversals match the adjacency lists */
+    std::vector<Vertex *> insertionOrder;
 
-    std::unordered_map<std::string, std::unique_ptr<Vertex>> graph;
+    friend class CompactGraph;
 };
 
 #endif /* __COLLAB_GRAPH__ */
\ No newline at end of file
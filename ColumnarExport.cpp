@@ -0,0 +1,304 @@
+/*
+ * ColumnarExport.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Writes the columnar export described in ColumnarExport.h, on
+ *   several threads, in chunks of bounded size.
+ */
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ColumnarExport.h"
+#include "Parallel.h"
+
+using namespace std;
+
+typedef CompactGraph::VertexId VertexId;
+typedef CompactGraph::SongId   SongId;
+
+namespace {
+
+const uint32_t FORMAT       = 1;
+const uint64_t HEADER_BYTES = 40;
+const size_t   CHUNK_BYTES  = 1 << 20;    /* per column, per thread */
+
+uint64_t align8(uint64_t x)
+{
+    return (x + 7) & ~uint64_t(7);
+}
+
+/* what every writer shares: the file, and whether to keep going */
+struct Output {
+    int fd;
+    const StopToken *stop;
+    atomic<ExportStatus> status;
+};
+
+/* one thread's stretch of one column; values collect here and go to
+ * their place in the file a chunk at a time */
+class Column {
+    public:
+        Column(Output &output, uint64_t position)
+            : output(output), position(position)
+        {
+            bytes.reserve(CHUNK_BYTES);
+        }
+        ~Column() { flush(); }
+
+        void put32(uint32_t x)
+        {
+            char le[4] = { char(x), char(x >> 8), char(x >> 16),
+                           char(x >> 24) };
+            put(string_view(le, sizeof le));
+        }
+        void put64(uint64_t x)
+        {
+            put32(uint32_t(x));
+            put32(uint32_t(x >> 32));
+        }
+        void put(string_view data)
+        {
+            bytes.insert(bytes.end(), data.begin(), data.end());
+            if (bytes.size() >= CHUNK_BYTES) {
+                flush();
+            }
+        }
+
+        void flush();
+
+    private:
+        Output &output;
+        uint64_t position;
+        vector<char> bytes;
+};
+
+/*
+ * @function: Column::flush
+ * @purpose: Writes the values collected so far to the file.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: The buffer is empty and the column continues right
+ * after what was written. Nothing is written once the export has
+ * been cancelled or has failed; a cancelled token or a write error
+ * found here ends it for every thread.
+ *
+ * @parameters: None.
+ *
+ * @returns: None.
+ */
+
+void Column::flush()
+{
+    if (output.stop != nullptr and output.stop->cancelled()) {
+        ExportStatus expected = ExportStatus::DONE;
+        output.status.compare_exchange_strong(expected,
+                                              ExportStatus::CANCELLED);
+    }
+    size_t done = 0;
+    while (output.status == ExportStatus::DONE and done < bytes.size()) {
+        ssize_t n = pwrite(output.fd, bytes.data() + done,
+                           bytes.size() - done, position + done);
+        if (n < 0 and errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            output.status = ExportStatus::FAILED;
+            break;
+        }
+        done += n;
+    }
+    position += bytes.size();
+    bytes.clear();
+}
+
+/* what one thread's range holds, and where its rows begin */
+struct Range {
+    uint64_t edges = 0, nameBytes = 0;
+    uint64_t firstEdge = 0, firstByte = 0;
+};
+
+/*
+ * @function: write_names
+ * @purpose: Writes one range of a name dictionary.
+ *
+ * @preconditions: 'range' holds the range's first byte.
+ *
+ * @postconditions: offsets[begin, end) and their names are written,
+ * and offsets[count] too by the last range.
+ *
+ * @parameters: output - The file (Output&), name - The name of id i
+ * (Name), begin, end - The ids of the range (size_t), count - How
+ * many names there are (size_t), range - Where the range starts
+ * (const Range&), offsetsAt, bytesAt - Where the dictionary's
+ * sections start (uint64_t).
+ *
+ * @returns: None.
+ */
+
+template <typename Name>
+void write_names(Output &output, Name name, size_t begin, size_t end,
+                 size_t count, const Range &range, uint64_t offsetsAt,
+                 uint64_t bytesAt)
+{
+    Column offsets(output, offsetsAt + 8 * begin);
+    Column names(output, bytesAt + range.firstByte);
+    uint64_t offset = range.firstByte;
+    for (size_t i = begin; i < end; i++) {
+        string_view text = name(i);
+        offsets.put64(offset);
+        names.put(text);
+        offset += text.size();
+    }
+    if (end == count) {
+        offsets.put64(offset);
+    }
+}
+
+/* firstEdge and firstByte of each range, from the counts */
+void place(vector<Range> &ranges)
+{
+    uint64_t edges = 0, bytes = 0;
+    for (Range &range : ranges) {
+        range.firstEdge = edges;
+        range.firstByte = bytes;
+        edges += range.edges;
+        bytes += range.nameBytes;
+    }
+}
+
+}
+
+/*
+ * @function: export_columnar
+ * @purpose: Writes the graph to a file in the columnar format.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: 'file' holds the graph as ColumnarExport.h lays it
+ * out, or, if the export was cancelled or failed, does not exist.
+ * Each of up to 'threads' threads holds at most a few chunks of the
+ * file in memory at once.
+ *
+ * @parameters: graph - The graph (const CompactGraph&), file - Where
+ * it goes (const string&), threads - How many threads write
+ * (size_t), edges - Set to the number of collaborations written
+ * (size_t&), stop - Ends the export early, or nullptr
+ * (const StopToken*).
+ *
+ * @returns: Whether the export was written, cancelled, or failed
+ * (ExportStatus).
+ */
+
+ExportStatus export_columnar(const CompactGraph &graph, const string &file,
+                             size_t threads, size_t &edges,
+                             const StopToken *stop)
+{
+    size_t artists = graph.vertex_count();
+    size_t songs   = graph.song_count();
+    threads = max<size_t>(1, threads);
+
+    /* count first, so every row's place in the file is known */
+    vector<Range> artistRanges(threads), songRanges(threads);
+    parallel_ranges(artists, threads, [&](size_t begin, size_t end,
+                                          size_t t) {
+        Range &range = artistRanges[t];
+        for (VertexId v = begin; v < end; v++) {
+            range.nameBytes += graph.vertex_name(v).size();
+            graph.for_each_neighbor_id(v, [&](VertexId n) {
+                range.edges += v < n;
+                return true;
+            });
+        }
+    });
+    parallel_ranges(songs, threads, [&](size_t begin, size_t end,
+                                        size_t t) {
+        for (SongId s = begin; s < end; s++) {
+            songRanges[t].nameBytes += graph.song_name(s).size();
+        }
+    });
+    place(artistRanges);
+    place(songRanges);
+
+    edges = artistRanges.back().firstEdge + artistRanges.back().edges;
+    uint64_t artistBytes = artistRanges.back().firstByte +
+                           artistRanges.back().nameBytes;
+    uint64_t songBytes = songRanges.back().firstByte +
+                         songRanges.back().nameBytes;
+
+    uint64_t artistOffsetsAt = align8(HEADER_BYTES);
+    uint64_t artistNamesAt   = artistOffsetsAt + 8 * (artists + 1);
+    uint64_t songOffsetsAt   = align8(artistNamesAt + artistBytes);
+    uint64_t songNamesAt     = songOffsetsAt + 8 * (songs + 1);
+    uint64_t fromAt          = align8(songNamesAt + songBytes);
+    uint64_t toAt            = fromAt + 4 * edges;
+    uint64_t edgeSongAt      = toAt + 4 * edges;
+    uint64_t fileBytes       = edgeSongAt + 4 * edges;
+
+    int fd = open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return ExportStatus::FAILED;
+    }
+    Output output { fd, stop, { ExportStatus::DONE } };
+    if (ftruncate(fd, fileBytes) != 0) {
+        output.status = ExportStatus::FAILED;
+    }
+
+    {
+        Column header(output, 0);
+        header.put("SDCX");
+        header.put32(FORMAT);
+        header.put32(uint32_t(artists));
+        header.put32(uint32_t(songs));
+        header.put64(edges);
+        header.put64(artistBytes);
+        header.put64(songBytes);
+    }
+
+    parallel_ranges(artists, threads, [&](size_t begin, size_t end,
+                                          size_t t) {
+        const Range &range = artistRanges[t];
+        write_names(output, [&](size_t v) { return graph.vertex_name(v); },
+                    begin, end, artists, range, artistOffsetsAt,
+                    artistNamesAt);
+
+        Column from(output, fromAt + 4 * range.firstEdge);
+        Column to(output, toAt + 4 * range.firstEdge);
+        Column song(output, edgeSongAt + 4 * range.firstEdge);
+        for (VertexId v = begin; v < end and
+                                 output.status == ExportStatus::DONE; v++) {
+            graph.for_each_neighbor(v, [&](VertexId n, SongId s) {
+                if (v < n) {
+                    from.put32(v);
+                    to.put32(n);
+                    song.put32(s);
+                }
+                return true;
+            });
+        }
+    });
+    parallel_ranges(songs, threads, [&](size_t begin, size_t end,
+                                        size_t t) {
+        write_names(output, [&](size_t s) { return graph.song_name(s); },
+                    begin, end, songs, songRanges[t], songOffsetsAt,
+                    songNamesAt);
+    });
+
+    if (close(fd) != 0 and output.status == ExportStatus::DONE) {
+        output.status = ExportStatus::FAILED;
+    }
+    if (output.status != ExportStatus::DONE) {
+        unlink(file.c_str());
+    }
+    return output.status;
+}
@@ -0,0 +1,45 @@
+/*
+ * ColumnarExport.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   The export command's file: the whole graph as columns of fixed
+ *   width ids, for tools that analyze it outside this program. Where
+ *   print_graph spells out one sentence per directed edge, this holds
+ *   each collaboration once as three 32-bit ids, and each name once.
+ *
+ *   Layout, every number little-endian, every section starting on an
+ *   8-byte boundary (zero padding before it):
+ *
+ *     header   "SDCX", u32 format (1), u32 artists V, u32 songs S,
+ *              u64 collaborations E, u64 artist name bytes,
+ *              u64 song title bytes
+ *     artists  u64 offsets[V + 1], then the names back to back;
+ *              artist v's name is bytes [offsets[v], offsets[v + 1])
+ *     songs    the same for the S song titles
+ *     edges    u32 from[E], then u32 to[E], then u32 song[E]: every
+ *              collaboration once, with from < to, sorted by 'from'
+ *              and then in adjacency order
+ *
+ *   Since every section's size is known from one counting pass, each
+ *   thread writes the rows of its own range of artists straight to
+ *   their places in the file, a bounded chunk at a time.
+ */
+#ifndef __COLUMNAR_EXPORT__
+#define __COLUMNAR_EXPORT__
+
+#include <cstddef>
+#include <string>
+
+#include "CompactGraph.h"
+#include "Traversal.h"
+
+enum class ExportStatus { DONE, CANCELLED, FAILED };
+
+ExportStatus export_columnar(const CompactGraph &graph,
+                             const std::string &file, size_t threads,
+                             size_t &edges,
+                             const StopToken *stop = nullptr);
+
+#endif /* __COLUMNAR_EXPORT__ */
@@ -0,0 +1,1101 @@
+/*
+ * CompactGraph.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Build and query the integer-indexed copy of a CollabGraph.
+ */
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <unordered_map>
+
+#include "CompactGraph.h"
+#include "CollabGraph.h"
+
+using namespace std;
+
+/*
+ * @constructor: CompactGraph
+ * @purpose: Constructs an empty CompactGraph.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: The graph has no vertices.
+ *
+ * @parameters: None.
+ *
+ * @returns: None.
+ */
+
+CompactGraph::CompactGraph()
+    : names(&arena), index(&arena), songs(&arena), songIndex(&arena),
+      offsets(&arena),
+      adjacency(&arena), edgeSongs(&arena), packedOffsets(&arena),
+      packed(&arena), songRunOffsets(&arena), songRuns(&arena),
+      credits(&arena), songOffsets(&arena), members(&arena)
+{
+    offsets.push_back(0);
+}
+
+/*
+ * @constructor: CompactGraph
+ * @purpose: Packs the vertices and edges of a CollabGraph into flat
+ * arrays.
+ *
+ * @preconditions: Every edge in 'source' connects two of its vertices.
+ *
+ * @postconditions: Vertex ids follow the insertion order of 'source'
+ * and each adjacency list keeps the order of the matching
+ * Vertex::neighbors, so a traversal visits neighbors exactly as a
+ * traversal of 'source' would.
+ *
+ * @parameters: source - The graph to copy (const CollabGraph&).
+ *
+ * @returns: None.
+ */
+
+CompactGraph::CompactGraph(const CollabGraph &source)
+    : CompactGraph()
+{
+    size_t vertexCount = source.insertionOrder.size();
+    size_t edgeTotal = 0;
+    for (CollabGraph::Vertex *vertex : source.insertionOrder) {
+        edgeTotal += vertex->neighbors.size();
+    }
+
+    /* sizes are known up front, so nothing is regrown in the arena */
+    names.reserve(vertexCount);
+    offsets.reserve(vertexCount + 1);
+    adjacency.reserve(edgeTotal);
+    edgeSongs.reserve(edgeTotal);
+
+    for (CollabGraph::Vertex *vertex : source.insertionOrder) {
+        names.push_back(arena.copy_string(vertex->artist.get_name()));
+    }
+    index.build(names);
+
+    /* keyed by views of the CollabGraph's strings, which outlive it */
+    unordered_map<string_view, SongId> songIds;
+    vector<string_view> songList;
+
+    for (CollabGraph::Vertex *vertex : source.insertionOrder) {
+        for (const CollabGraph::Edge &edge : vertex->neighbors) {
+            auto song = songIds.find(edge.song);
+            if (song == songIds.end()) {
+                song = songIds.emplace(edge.song, songList.size()).first;
+                songList.push_back(edge.song);
+            }
+            adjacency.push_back(index.find(edge.neighbor->artist.get_name()));
+            edgeSongs.push_back(song->second);
+        }
+        offsets.push_back(adjacency.size());
+    }
+    directedEdges = adjacency.size();
+
+    songs.reserve(songList.size());
+    for (string_view song : songList) {
+        songs.push_back(arena.copy_string(song));
+    }
+    songIndex.build(songs);
+}
+
+/*
+ * @function: bipartite
+ * @purpose: Builds a graph that stores the song credits of a dataset
+ * instead of its pairwise collaborations.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: Artist ids follow the order of 'artists'. Only songs
+ * credited to two or more artists are kept. The pairwise view of the
+ * graph (for_each_neighbor, edge_song) is the one setEdges would
+ * build: each artist's collaborators in list order, and each edge's
+ * song the first one in the earlier artist's discography that the
+ * other artist also has.
+ *
+ * @parameters: artists - The artists, in the order setEdges would see
+ * them (const vector<Artist*>&).
+ *
+ * @returns: The graph, or nullptr if two artists share a name or a
+ * song title is blank, where setEdges does more than take the first
+ * shared song (unique_ptr<CompactGraph>).
+ */
+
+unique_ptr<CompactGraph>
+CompactGraph::bipartite(const vector<Artist *> &artists)
+{
+    unique_ptr<CompactGraph> graph = make_unique<CompactGraph>();
+    graph->isBipartite = true;
+
+    graph->names.reserve(artists.size());
+    for (Artist *artist : artists) {
+        graph->names.push_back(graph->arena.copy_string(artist->get_name()));
+    }
+    graph->index.build(graph->names);
+    for (VertexId v = 0; v < artists.size(); v++) {
+        if (graph->index.find(graph->names[v]) != v) {
+            return nullptr;
+        }
+    }
+
+    /* every distinct title, numbered as first seen; a title listed
+     * twice by one artist is credited to it once */
+    unordered_map<string_view, uint32_t> titleIds;
+    vector<string_view> titles;
+    vector<uint32_t>    artistCount;
+    vector<VertexId>    lastArtist;
+    for (VertexId v = 0; v < artists.size(); v++) {
+        for (const string &song : artists[v]->get_discography()) {
+            if (song.empty()) {
+                return nullptr;
+            }
+            auto title = titleIds.emplace(song, titles.size()).first;
+            if (title->second == titles.size()) {
+                titles.push_back(song);
+                artistCount.push_back(0);
+                lastArtist.push_back(VertexId(NO_VERTEX));
+            }
+            if (lastArtist[title->second] != v) {
+                lastArtist[title->second] = v;
+                artistCount[title->second]++;
+            }
+        }
+    }
+
+    /* only shared titles become songs */
+    vector<SongId> songOf(titles.size(), SongId(NO_SONG));
+    size_t shared = 0;
+    size_t sharedCredits = 0;
+    for (size_t t = 0; t < titles.size(); t++) {
+        if (artistCount[t] > 1) {
+            songOf[t] = shared++;
+            sharedCredits += artistCount[t];
+        }
+    }
+
+    graph->songs.reserve(shared);
+    graph->songOffsets.assign(shared + 1, 0);
+    for (size_t t = 0; t < titles.size(); t++) {
+        if (songOf[t] != NO_SONG) {
+            graph->songs.push_back(graph->arena.copy_string(titles[t]));
+            graph->songOffsets[songOf[t] + 1] = artistCount[t];
+        }
+    }
+    graph->songIndex.build(graph->songs);
+    for (size_t s = 0; s < shared; s++) {
+        graph->songOffsets[s + 1] += graph->songOffsets[s];
+    }
+
+    /* artists are scanned in order, so every member list ascends */
+    vector<size_t> cursor(graph->songOffsets.begin(),
+                          graph->songOffsets.end() - 1);
+    graph->offsets.reserve(artists.size() + 1);
+    graph->credits.reserve(sharedCredits);
+    graph->members.resize(sharedCredits);
+    fill(lastArtist.begin(), lastArtist.end(), VertexId(NO_VERTEX));
+    for (VertexId v = 0; v < artists.size(); v++) {
+        for (const string &song : artists[v]->get_discography()) {
+            uint32_t t = titleIds.find(song)->second;
+            if (songOf[t] == NO_SONG or lastArtist[t] == v) {
+                continue;
+            }
+            lastArtist[t] = v;
+            graph->credits.push_back(songOf[t]);
+            graph->members[cursor[songOf[t]]++] = v;
+        }
+        graph->offsets.push_back(graph->credits.size());
+    }
+    return graph;
+}
+
+/*
+ * @function: vertex_count
+ * @purpose: Reports the number of vertices.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: The number of artists in the graph (size_t).
+ */
+
+size_t CompactGraph::vertex_count() const
+{
+    return names.size();
+}
+
+/*
+ * @function: edge_count
+ * @purpose: Reports the number of undirected edges.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: The number of collaborations in the graph, or 0 for a
+ * bipartite graph, which does not count them (size_t).
+ */
+
+size_t CompactGraph::edge_count() const
+{
+    return directedEdges / 2;
+}
+
+/*
+ * @function: find_vertex
+ * @purpose: Looks up the id of an artist by name.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: name - The artist's name (string_view).
+ *
+ * @returns: The artist's id, or NO_VERTEX if the artist is not in
+ * the graph (VertexId).
+ */
+
+CompactGraph::VertexId CompactGraph::find_vertex(string_view name) const
+{
+    return index.find(name);
+}
+
+/*
+ * @function: song_count
+ * @purpose: Reports the number of interned songs.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: One more than the largest song id (size_t).
+ */
+
+size_t CompactGraph::song_count() const
+{
+    return songs.size();
+}
+
+/*
+ * @function: find_song
+ * @purpose: Looks up the id of a song by title.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: title - The song's title (string_view).
+ *
+ * @returns: The song's id, or NO_SONG if no collaboration in the
+ * graph is on that song (SongId).
+ */
+
+CompactGraph::SongId CompactGraph::find_song(string_view title) const
+{
+    return songIndex.find(title);
+}
+
+/*
+ * @function: vertex_name
+ * @purpose: Retrieves the name of the artist with the given id.
+ *
+ * @preconditions: 'v' is less than vertex_count().
+ *
+ * @postconditions: None.
+ *
+ * @parameters: v - An artist id (VertexId).
+ *
+ * @returns: The artist's name, valid as long as the graph
+ * (string_view).
+ */
+
+string_view CompactGraph::vertex_name(VertexId v) const
+{
+    return names[v];
+}
+
+/*
+ * @function: song_name
+ * @purpose: Retrieves the title of an interned song.
+ *
+ * @preconditions: 's' was read from this graph's adjacency.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: s - A song id (SongId).
+ *
+ * @returns: The song's title, valid as long as the graph
+ * (string_view).
+ */
+
+string_view CompactGraph::song_name(SongId s) const
+{
+    return songs[s];
+}
+
+/*
+ * @function: degree
+ * @purpose: Reports how many collaborators an artist has.
+ *
+ * @preconditions: 'v' is less than vertex_count().
+ *
+ * @postconditions: None.
+ *
+ * @parameters: v - An artist id (VertexId).
+ *
+ * @returns: The number of neighbors of 'v' (size_t).
+ */
+
+size_t CompactGraph::degree(VertexId v) const
+{
+    if (isBipartite) {
+        vector<VertexId> list;
+        collaborator_ids(v, list);
+        return list.size();
+    }
+    if (isCompressed) {
+        /* every varint ends in the one byte below 0x80 */
+        return count_if(packed.begin() + packedOffsets[v],
+                        packed.begin() + packedOffsets[v + 1],
+                        [](uint8_t byte) { return byte < 0x80; });
+    }
+    return offsets[v + 1] - offsets[v];
+}
+
+/*
+ * @function: neighbors_begin / neighbors_end
+ * @purpose: Delimit the adjacency list of an artist.
+ *
+ * @preconditions: 'v' is less than vertex_count() and the graph is
+ * not compressed.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: v - An artist id (VertexId).
+ *
+ * @returns: Pointers to the first and one-past-last neighbor of 'v'
+ * (const VertexId*).
+ */
+
+const CompactGraph::VertexId *CompactGraph::neighbors_begin(VertexId v) const
+{
+    return adjacency.data() + offsets[v];
+}
+
+const CompactGraph::VertexId *CompactGraph::neighbors_end(VertexId v) const
+{
+    return adjacency.data() + offsets[v + 1];
+}
+
+/*
+ * @function: songs_begin
+ * @purpose: Gives the songs of an artist's edges, parallel to
+ * neighbors_begin.
+ *
+ * @preconditions: 'v' is less than vertex_count() and the graph is
+ * not compressed.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: v - An artist id (VertexId).
+ *
+ * @returns: A pointer to the song of the first edge of 'v'
+ * (const SongId*).
+ */
+
+const CompactGraph::SongId *CompactGraph::songs_begin(VertexId v) const
+{
+    return edgeSongs.data() + offsets[v];
+}
+
+/*
+ * @function: get_edge
+ * @purpose: Retrieves the song connecting two artists.
+ *
+ * @preconditions: 'a' and 'b' are less than vertex_count().
+ *
+ * @postconditions: None.
+ *
+ * @parameters: a, b - Artist ids (VertexId).
+ *
+ * @returns: The song 'a' and 'b' collaborated in, or the empty string
+ * if they never collaborated (string).
+ */
+
+string CompactGraph::get_edge(VertexId a, VertexId b) const
+{
+    SongId song = edge_song(a, b);
+    if (song == NO_SONG) {
+        return "";
+    }
+    return string(songs[song]);
+}
+
+/*
+ * @function: edge_song
+ * @purpose: Retrieves the song connecting two artists without copying
+ * its title.
+ *
+ * @preconditions: 'a' and 'b' are less than vertex_count().
+ *
+ * @postconditions: None.
+ *
+ * @parameters: a, b - Artist ids (VertexId).
+ *
+ * @returns: The id of the song 'a' and 'b' collaborated in, or
+ * NO_SONG if they never collaborated (SongId).
+ */
+
+CompactGraph::SongId CompactGraph::edge_song(VertexId a, VertexId b) const
+{
+    if (isBipartite) {
+        /* the first song of the earlier artist the later one is on */
+        VertexId first = min(a, b);
+        VertexId second = max(a, b);
+        if (first == second) {
+            return NO_SONG;
+        }
+        for (const SongId *s = credits_begin(first);
+                           s != credits_end(first); s++) {
+            if (binary_search(members_begin(*s), members_end(*s), second)) {
+                return *s;
+            }
+        }
+        return NO_SONG;
+    }
+
+    SongId edge = NO_SONG;
+    for_each_neighbor(a, [&](VertexId n, SongId song) {
+        if (n == b) {
+            edge = song;
+            return false;
+        }
+        return true;
+    });
+    return edge;
+}
+
+/*
+ * @function: credits_begin / credits_end
+ * @purpose: Delimit the shared songs an artist is credited on.
+ *
+ * @preconditions: 'v' is less than vertex_count() and the graph is
+ * bipartite.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: v - An artist id (VertexId).
+ *
+ * @returns: Pointers to the first and one-past-last song of 'v', in
+ * the order of its discography (const SongId*).
+ */
+
+const CompactGraph::SongId *CompactGraph::credits_begin(VertexId v) const
+{
+    return credits.data() + offsets[v];
+}
+
+const CompactGraph::SongId *CompactGraph::credits_end(VertexId v) const
+{
+    return credits.data() + offsets[v + 1];
+}
+
+/*
+ * @function: members_begin / members_end
+ * @purpose: Delimit the artists credited on a song.
+ *
+ * @preconditions: 's' is less than song_count() and the graph is
+ * bipartite.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: s - A song id (SongId).
+ *
+ * @returns: Pointers to the first and one-past-last artist of 's', in
+ * ascending order (const VertexId*).
+ */
+
+const CompactGraph::VertexId *CompactGraph::members_begin(SongId s) const
+{
+    return members.data() + songOffsets[s];
+}
+
+const CompactGraph::VertexId *CompactGraph::members_end(SongId s) const
+{
+    return members.data() + songOffsets[s + 1];
+}
+
+/*
+ * @function: credit_count
+ * @purpose: Reports the number of (artist, shared song) credits a
+ * bipartite graph stores.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: The number of credits, 0 for a pairwise graph (size_t).
+ */
+
+size_t CompactGraph::credit_count() const
+{
+    return credits.size();
+}
+
+/*
+ * @function: collaborators
+ * @purpose: Derives the adjacency list of an artist in a bipartite
+ * graph.
+ *
+ * @preconditions: 'v' is less than vertex_count() and the graph is
+ * bipartite.
+ *
+ * @postconditions: 'out' holds each collaborator of 'v' once, in
+ * ascending order, with the song edge_song would give, which is the
+ * list (and songs) the pairwise layout stores for 'v'.
+ *
+ * @parameters: v - An artist id (VertexId), out - Filled with
+ * (collaborator, song) pairs (vector<pair<VertexId, SongId>>&).
+ *
+ * @returns: None.
+ */
+
+void CompactGraph::collaborators(VertexId v,
+                                 vector<pair<VertexId, SongId>> &out) const
+{
+    /* (artist, position of the song in v's list); sorting puts each
+     * artist's first shared song of v first */
+    out.clear();
+    const SongId *first = credits_begin(v);
+    for (const SongId *s = first; s != credits_end(v); s++) {
+        for (const VertexId *n = members_begin(*s);
+                             n != members_end(*s); n++) {
+            if (*n != v) {
+                out.emplace_back(*n, s - first);
+            }
+        }
+    }
+    sort(out.begin(), out.end());
+    out.erase(unique(out.begin(), out.end(),
+                     [](const pair<VertexId, SongId> &a,
+                        const pair<VertexId, SongId> &b) {
+                         return a.first == b.first;
+                     }),
+              out.end());
+
+    /* an earlier artist's edge takes its song from that artist */
+    for (pair<VertexId, SongId> &edge : out) {
+        edge.second = edge.first > v ? first[edge.second]
+                                     : edge_song(edge.first, v);
+    }
+}
+
+/*
+ * @function: collaborator_ids
+ * @purpose: Derives the adjacency list of an artist in a bipartite
+ * graph, without the songs.
+ *
+ * @preconditions: 'v' is less than vertex_count() and the graph is
+ * bipartite.
+ *
+ * @postconditions: 'out' holds each collaborator of 'v' once, in
+ * ascending order.
+ *
+ * @parameters: v - An artist id (VertexId), out - Filled with the
+ * collaborators (vector<VertexId>&).
+ *
+ * @returns: None.
+ */
+
+void CompactGraph::collaborator_ids(VertexId v, vector<VertexId> &out) const
+{
+    out.clear();
+    for (const SongId *s = credits_begin(v); s != credits_end(v); s++) {
+        out.insert(out.end(), members_begin(*s), members_end(*s));
+    }
+    sort(out.begin(), out.end());
+    out.erase(unique(out.begin(), out.end()), out.end());
+
+    /* v is on each of its own songs */
+    auto self = lower_bound(out.begin(), out.end(), v);
+    if (self != out.end() and *self == v) {
+        out.erase(self);
+    }
+}
+
+/*
+ * @function: parse_vertex_order
+ * @purpose: Reads the name of a vertex numbering.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: 'order' is set iff the name is recognized.
+ *
+ * @parameters: name - One of "insertion", "bfs", "rcm" or "degree"
+ * (const string&), order - The matching order (VertexOrder&).
+ *
+ * @returns: True iff 'name' names an order.
+ */
+
+bool parse_vertex_order(const string &name, VertexOrder &order)
+{
+    if (name == "insertion") {
+        order = VertexOrder::INSERTION;
+    } else if (name == "bfs") {
+        order = VertexOrder::BFS;
+    } else if (name == "rcm") {
+        order = VertexOrder::RCM;
+    } else if (name == "degree") {
+        order = VertexOrder::DEGREE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/*
+ * @function: relabeled
+ * @purpose: Builds a copy of the graph with its vertices renumbered.
+ *
+ * @preconditions: The graph is not bipartite.
+ *
+ * @postconditions: The copy holds the same artists, songs and edges
+ * in the same storage mode. The neighbors of every artist are listed
+ * in the same order as in this graph, so searches over the copy
+ * report the same paths.
+ *
+ * @parameters: order - How the copy's vertices are numbered
+ * (VertexOrder).
+ *
+ * @returns: The renumbered graph (unique_ptr<CompactGraph>).
+ */
+
+unique_ptr<CompactGraph> CompactGraph::relabeled(VertexOrder order) const
+{
+    vector<VertexId> oldIds;
+    switch (order) {
+        case VertexOrder::INSERTION:
+            oldIds.resize(vertex_count());
+            for (VertexId v = 0; v < oldIds.size(); v++) {
+                oldIds[v] = v;
+            }
+            break;
+        case VertexOrder::BFS:    oldIds = bfs_order();    break;
+        case VertexOrder::RCM:    oldIds = rcm_order();    break;
+        case VertexOrder::DEGREE: oldIds = degree_order(); break;
+    }
+
+    vector<VertexId> newIds(vertex_count());
+    for (size_t i = 0; i < oldIds.size(); i++) {
+        newIds[oldIds[i]] = i;
+    }
+
+    unique_ptr<CompactGraph> copy = make_unique<CompactGraph>();
+    copy->copy_names(*this, oldIds);
+    copy->offsets.reserve(vertex_count() + 1);
+    copy->adjacency.reserve(directedEdges);
+    copy->edgeSongs.reserve(directedEdges);
+
+    for (VertexId old : oldIds) {
+        for_each_neighbor(old, [&](VertexId n, SongId song) {
+            copy->adjacency.push_back(newIds[n]);
+            copy->edgeSongs.push_back(song);
+            return true;
+        });
+        copy->offsets.push_back(copy->adjacency.size());
+    }
+    copy->directedEdges = copy->adjacency.size();
+
+    if (isCompressed) {
+        return copy->compressed();
+    }
+    return copy;
+}
+
+/*
+ * @function: copy_names
+ * @purpose: Copies the artist and song names of another graph into
+ * this graph's arena.
+ *
+ * @preconditions: This graph has no vertices yet.
+ *
+ * @postconditions: Artist i of this graph is artist oldIds[i] of
+ * 'source'; song ids are unchanged.
+ *
+ * @parameters: source - The graph to copy from (const CompactGraph&),
+ * oldIds - The new vertex order (const vector<VertexId>&).
+ *
+ * @returns: None.
+ */
+
+void CompactGraph::copy_names(const CompactGraph &source,
+                              const vector<VertexId> &oldIds)
+{
+    names.reserve(oldIds.size());
+    for (VertexId old : oldIds) {
+        names.push_back(arena.copy_string(source.names[old]));
+    }
+    index.build(names);
+
+    songs.reserve(source.songs.size());
+    for (string_view song : source.songs) {
+        songs.push_back(arena.copy_string(song));
+    }
+    songIndex.build(songs);
+}
+
+/*
+ * @function: mean_neighbor_gap
+ * @purpose: Measures how far apart collaborators are numbered, a
+ * proxy for how many cache lines a search touches.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: The average of |u - v| over every edge (double).
+ */
+
+double CompactGraph::mean_neighbor_gap() const
+{
+    if (directedEdges == 0) {
+        return 0;
+    }
+
+    double total = 0;
+    for (VertexId v = 0; v < vertex_count(); v++) {
+        for_each_neighbor_id(v, [&](VertexId n) {
+            total += (n > v) ? n - v : v - n;
+            return true;
+        });
+    }
+    return total / directedEdges;
+}
+
+/*
+ * @function: bfs_order
+ * @purpose: Numbers vertices in breadth-first order, so each
+ * artist's collaborators are numbered close to one another.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: The old ids in their new order (vector<VertexId>).
+ */
+
+vector<CompactGraph::VertexId> CompactGraph::bfs_order() const
+{
+    /* start each component at its best-connected artist */
+    vector<VertexId> seeds = degree_order();
+    vector<bool> placed(vertex_count(), false);
+    vector<VertexId> order;
+    order.reserve(vertex_count());
+
+    for (VertexId seed : seeds) {
+        if (placed[seed]) {
+            continue;
+        }
+        placed[seed] = true;
+        order.push_back(seed);
+        for (size_t head = order.size() - 1; head < order.size(); head++) {
+            for_each_neighbor(order[head], [&](VertexId n, SongId) {
+                if (not placed[n]) {
+                    placed[n] = true;
+                    order.push_back(n);
+                }
+                return true;
+            });
+        }
+    }
+    return order;
+}
+
+/*
+ * @function: rcm_order
+ * @purpose: Numbers vertices in Reverse Cuthill-McKee order, which
+ * keeps the bandwidth of the adjacency matrix small.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: The old ids in their new order (vector<VertexId>).
+ */
+
+vector<CompactGraph::VertexId> CompactGraph::rcm_order() const
+{
+    /* Cuthill-McKee starts each component at a low-degree (peripheral)
+     * artist and visits the neighbors of each artist lowest degree
+     * first; reversing the result gives RCM */
+    vector<VertexId> seeds = degree_order();
+    reverse(seeds.begin(), seeds.end());
+
+    vector<bool> placed(vertex_count(), false);
+    vector<VertexId> order;
+    vector<VertexId> found;
+    order.reserve(vertex_count());
+
+    for (VertexId seed : seeds) {
+        if (placed[seed]) {
+            continue;
+        }
+        placed[seed] = true;
+        order.push_back(seed);
+        for (size_t head = order.size() - 1; head < order.size(); head++) {
+            found.clear();
+            for_each_neighbor(order[head], [&](VertexId n, SongId) {
+                if (not placed[n]) {
+                    placed[n] = true;
+                    found.push_back(n);
+                }
+                return true;
+            });
+            stable_sort(found.begin(), found.end(),
+                        [this](VertexId a, VertexId b) {
+                            return degree(a) < degree(b);
+                        });
+            order.insert(order.end(), found.begin(), found.end());
+        }
+    }
+
+    reverse(order.begin(), order.end());
+    return order;
+}
+
+/*
+ * @function: degree_order
+ * @purpose: Numbers vertices by decreasing degree, packing the
+ * heavily shared hub artists together.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: The old ids in their new order (vector<VertexId>).
+ */
+
+vector<CompactGraph::VertexId> CompactGraph::degree_order() const
+{
+    vector<VertexId> order(vertex_count());
+    for (VertexId v = 0; v < order.size(); v++) {
+        order[v] = v;
+    }
+    stable_sort(order.begin(), order.end(),
+                [this](VertexId a, VertexId b) {
+                    return degree(a) > degree(b);
+                });
+    return order;
+}
+
+/*
+ * @function: compressed
+ * @purpose: Builds a copy of the graph whose adjacency lists are
+ * delta and varint encoded, with their songs in a stream of their own.
+ *
+ * @preconditions: The graph is not bipartite.
+ *
+ * @postconditions: The copy lists the same neighbors and songs in the
+ * same order, so searches over it report the same paths. Its raw
+ * adjacency arrays are empty; use for_each_neighbor instead. Lists are
+ * found through 32-bit offsets, so if either stream would outgrow them
+ * the copy is left uncompressed.
+ *
+ * @parameters: None.
+ *
+ * @returns: The compressed graph (unique_ptr<CompactGraph>).
+ */
+
+unique_ptr<CompactGraph> CompactGraph::compressed() const
+{
+    if (isCompressed) {
+        return relabeled(VertexOrder::INSERTION);
+    }
+
+    /* encode on the heap first so the arena gets exact-size copies */
+    vector<uint8_t> neighborBytes, songBytes;
+    vector<uint32_t> neighborAt, songAt;
+    neighborBytes.reserve(directedEdges * 2 + vertex_count());
+    neighborAt.reserve(vertex_count() + 1);
+    songAt.reserve(vertex_count() + 1);
+
+    for (VertexId v = 0; v < vertex_count(); v++) {
+        neighborAt.push_back(neighborBytes.size());
+        songAt.push_back(songBytes.size());
+
+        VertexId prev = v;
+        for (const VertexId *n = neighbors_begin(v);
+                              n != neighbors_end(v); n++) {
+            write_varint(neighborBytes,
+                         zigzag(static_cast<int32_t>(*n - prev)));
+            prev = *n;
+        }
+
+        /* an artist's edges come a song at a time, so runs are long */
+        SongId prevSong = 0;
+        const SongId *song = songs_begin(v);
+        const SongId *songsEnd = song + degree(v);
+        while (song != songsEnd) {
+            const SongId *runEnd = song;
+            while (runEnd != songsEnd and *runEnd == *song) {
+                runEnd++;
+            }
+            write_varint(songBytes,
+                         zigzag(static_cast<int32_t>(*song - prevSong)));
+            write_varint(songBytes, runEnd - song);
+            prevSong = *song;
+            song = runEnd;
+        }
+    }
+    /* an offset that overflowed is caught here, at the largest */
+    if (neighborBytes.size() > UINT32_MAX or songBytes.size() > UINT32_MAX) {
+        return relabeled(VertexOrder::INSERTION);
+    }
+    neighborAt.push_back(neighborBytes.size());
+    songAt.push_back(songBytes.size());
+
+    vector<VertexId> sameIds(vertex_count());
+    for (VertexId v = 0; v < sameIds.size(); v++) {
+        sameIds[v] = v;
+    }
+
+    unique_ptr<CompactGraph> copy = make_unique<CompactGraph>();
+    copy->copy_names(*this, sameIds);
+    copy->isCompressed = true;
+    copy->directedEdges = directedEdges;
+    copy->offsets.clear();
+    copy->offsets.shrink_to_fit();
+    copy->packedOffsets.assign(neighborAt.begin(), neighborAt.end());
+    copy->packed.assign(neighborBytes.begin(), neighborBytes.end());
+    copy->songRunOffsets.assign(songAt.begin(), songAt.end());
+    copy->songRuns.assign(songBytes.begin(), songBytes.end());
+    return copy;
+}
+
+/*
+ * @function: is_compressed
+ * @purpose: Reports the storage mode of the adjacency lists.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: True iff the adjacency lists are varint encoded.
+ */
+
+bool CompactGraph::is_compressed() const
+{
+    return isCompressed;
+}
+
+/*
+ * @function: is_bipartite
+ * @purpose: Reports whether the graph stores song credits instead of
+ * pairwise edges.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: True iff the graph was built by bipartite().
+ */
+
+bool CompactGraph::is_bipartite() const
+{
+    return isBipartite;
+}
+
+/*
+ * @function: adjacency_bytes
+ * @purpose: Reports the memory held by the adjacency lists.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: The bytes used by offsets, neighbors and edge songs,
+ * packed or not, or by the credits of a bipartite graph (size_t).
+ */
+
+size_t CompactGraph::adjacency_bytes() const
+{
+    return offsets.capacity() * sizeof(size_t) +
+           adjacency.capacity() * sizeof(VertexId) +
+           edgeSongs.capacity() * sizeof(SongId) +
+           packedOffsets.capacity() * sizeof(uint32_t) +
+           packed.capacity() +
+           songRunOffsets.capacity() * sizeof(uint32_t) +
+           songRuns.capacity() +
+           credits.capacity() * sizeof(SongId) +
+           songOffsets.capacity() * sizeof(size_t) +
+           members.capacity() * sizeof(VertexId);
+}
+
+/*
+ * @function: arena_bytes
+ * @purpose: Reports the memory held by the graph's arena: names,
+ * songs, index and adjacency.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: The bytes reserved by the arena (size_t).
+ */
+
+size_t CompactGraph::arena_bytes() const
+{
+    return arena.bytes_reserved();
+}
+
+/*
+ * @function: write_varint
+ * @purpose: Appends one little-endian base-128 integer.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: One to five bytes are appended to 'out'.
+ *
+ * @parameters: out - The byte stream (vector<uint8_t>&), x - The
+ * value to encode (uint32_t).
+ *
+ * @returns: None.
+ */
+
+void CompactGraph::write_varint(vector<uint8_t> &out, uint32_t x)
+{
+    while (x >= 0x80) {
+        out.push_back(static_cast<uint8_t>(x | 0x80));
+        x >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(x));
+}
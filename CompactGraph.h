@@ -0,0 +1,321 @@
+/*
+ * CompactGraph.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   A read-only, integer-indexed copy of a CollabGraph. Every artist
+ *   is numbered 0..n-1 in the order it was inserted, every song is
+ *   interned once, and the adjacency lists are packed into flat arrays
+ *   (compressed sparse rows) so traversals never hash a name or copy
+ *   an Artist once the source vertex has been looked up.
+ *
+ *   The ids can be renumbered (BFS, Reverse Cuthill-McKee or degree
+ *   order) so that collaborators sit close together in memory. Each
+ *   adjacency list keeps its original order under every numbering, so
+ *   searches report exactly the same paths whichever order is used.
+ *
+ *   The adjacency can also be compressed: each list is stored as the
+ *   varint-encoded difference between consecutive neighbor ids (zigzag
+ *   encoded, so a list that is not ascending still works), and the
+ *   songs of its edges are kept in a stream of their own, as runs of
+ *   equal songs, so a search that ignores songs never reads them.
+ *   Lists are decoded on the fly by for_each_neighbor and
+ *   for_each_neighbor_id, which work in either mode.
+ *
+ *   Instead of pairwise edges, a graph can store who is credited on
+ *   each song (see bipartite()): the songs of every artist and the
+ *   artists of every song shared by two or more of them. A song with k
+ *   artists then costs 2k ids rather than k(k - 1) edges. The pairwise
+ *   view is derived on demand, with the same neighbor order and edge
+ *   songs as the pairwise layout, so every search reports the same
+ *   paths; breadth-first search walks artist -> song -> artist and
+ *   expands each song only once (see FrontierKernel.h).
+ *
+ *   Artist names and song titles are looked up through NameIndexes,
+ *   flat tables with a Bloom filter in front, built once the names are
+ *   final.
+ *
+ *   Every array, string and index node of a CompactGraph lives in the
+ *   graph's own arena, so building it makes a handful of large
+ *   allocations and destroying it frees everything in one shot.
+ */
+#ifndef __COMPACT_GRAPH__
+#define __COMPACT_GRAPH__
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Artist.h"
+#include "CollabGraph.h"
+#include "Arena.h"
+#include "NameIndex.h"
+
+/* how vertices are numbered when the graph is packed */
+enum class VertexOrder { INSERTION, BFS, RCM, DEGREE };
+
+bool parse_vertex_order(const std::string &name, VertexOrder &order);
+
+class CompactGraph {
+    public:
+        typedef uint32_t VertexId;
+        typedef uint32_t SongId;
+
+        static const VertexId NO_VERTEX = UINT32_MAX;
+        static const SongId   NO_SONG   = UINT32_MAX;
+
+        CompactGraph();
+        explicit CompactGraph(const CollabGraph &source);
+
+        /* credits only, no pairwise edges; nullptr if the dataset
+         * needs setEdges (see buildCollabEdges) */
+        static std::unique_ptr<CompactGraph>
+        bipartite(const std::vector<Artist *> &artists);
+
+        /* the graph's data lives in its arena, so it is never copied;
+         * relabeled() and compressed() build new graphs instead */
+        CompactGraph(const CompactGraph &) = delete;
+        CompactGraph &operator=(const CompactGraph &) = delete;
+
+        size_t vertex_count() const;
+        size_t edge_count() const;
+        size_t song_count() const;
+
+        VertexId         find_vertex(std::string_view name) const;
+        SongId           find_song(std::string_view title) const;
+        std::string_view vertex_name(VertexId v) const;
+        std::string_view song_name(SongId s) const;
+
+        size_t degree(VertexId v) const;
+
+        /* calls visit(neighbor, song) for each edge of 'v', in order,
+         * until visit returns false; returns false iff it was stopped */
+        template <typename Visit>
+        bool for_each_neighbor(VertexId v, Visit visit) const;
+
+        /* as for_each_neighbor, but calls visit(neighbor) only, which
+         * spares a compressed graph decoding the songs */
+        template <typename Visit>
+        bool for_each_neighbor_id(VertexId v, Visit visit) const;
+
+        /* raw adjacency arrays; only valid when not is_compressed() */
+        const VertexId *neighbors_begin(VertexId v) const;
+        const VertexId *neighbors_end(VertexId v) const;
+        const SongId   *songs_begin(VertexId v) const;
+
+        SongId      edge_song(VertexId a, VertexId b) const;
+        std::string get_edge(VertexId a, VertexId b) const;
+
+        /* credit arrays; only valid when is_bipartite(). The songs of
+         * v are in discography order, the artists of s ascend */
+        const SongId   *credits_begin(VertexId v) const;
+        const SongId   *credits_end(VertexId v) const;
+        const VertexId *members_begin(SongId s) const;
+        const VertexId *members_end(SongId s) const;
+        size_t          credit_count() const;
+
+        /* relabeled() and compressed() need the pairwise layout */
+        std::unique_ptr<CompactGraph> relabeled(VertexOrder order) const;
+        std::unique_ptr<CompactGraph> compressed() const;
+        bool   is_compressed() const;
+        bool   is_bipartite() const;
+        size_t adjacency_bytes() const;
+        size_t arena_bytes() const;
+        double mean_neighbor_gap() const;
+
+    private:
+        static uint32_t read_varint(const uint8_t *&p);
+        static void     write_varint(std::vector<uint8_t> &out, uint32_t x);
+        static uint32_t zigzag(int32_t delta);
+        static int32_t  unzigzag(uint32_t x);
+
+        std::vector<VertexId> bfs_order() const;
+        std::vector<VertexId> rcm_order() const;
+        std::vector<VertexId> degree_order() const;
+
+        void copy_names(const CompactGraph &source,
+                        const std::vector<VertexId> &oldIds);
+        void collaborators(VertexId v,
+                   std::vector<std::pair<VertexId, SongId>> &out) const;
+        void collaborator_ids(VertexId v, std::vector<VertexId> &out) const;
+
+        /* declared first so it outlives every container below */
+        Arena arena;
+
+        std::pmr::vector<std::string_view> names;
+        NameIndex index;
+        std::pmr::vector<std::string_view> songs;
+        NameIndex songIndex;
+
+        /* neighbors of v are adjacency[offsets[v] .. offsets[v + 1]) and
+         * the song of each of those edges is at the same position in
+         * edgeSongs */
+        std::pmr::vector<size_t>   offsets;
+        std::pmr::vector<VertexId> adjacency;
+        std::pmr::vector<SongId>   edgeSongs;
+
+        /* when compressed, adjacency and edgeSongs are empty and
+         * offsets is unused. The neighbors of v are one zigzag delta
+         * each (from v, then from the previous neighbor) in
+         * packed[packedOffsets[v] .. packedOffsets[v + 1]); their songs
+         * are (zigzag song delta, run length) pairs in
+         * songRuns[songRunOffsets[v] .. songRunOffsets[v + 1]) */
+        bool isCompressed = false;
+        size_t directedEdges = 0;
+        std::pmr::vector<uint32_t> packedOffsets;
+        std::pmr::vector<uint8_t>  packed;
+        std::pmr::vector<uint32_t> songRunOffsets;
+        std::pmr::vector<uint8_t>  songRuns;
+
+        /* when bipartite, adjacency and edgeSongs are empty and the
+         * songs of v are credits[offsets[v] .. offsets[v + 1]); the
+         * artists of song s are members[songOffsets[s] ..
+         * songOffsets[s + 1]) */
+        bool isBipartite = false;
+        std::pmr::vector<SongId>   credits;
+        std::pmr::vector<size_t>   songOffsets;
+        std::pmr::vector<VertexId> members;
+};
+
+/*
+ * @function: read_varint
+ * @purpose: Decodes one little-endian base-128 integer.
+ *
+ * @preconditions: 'p' points at an encoded integer.
+ *
+ * @postconditions: 'p' points just past the integer.
+ *
+ * @parameters: p - The read position (const uint8_t*&).
+ *
+ * @returns: The decoded value (uint32_t).
+ */
+
+inline uint32_t CompactGraph::read_varint(const uint8_t *&p)
+{
+    uint32_t x = *p++;
+    if (x < 0x80) {
+        return x;
+    }
+    x &= 0x7f;
+    for (int shift = 7; ; shift += 7) {
+        uint32_t byte = *p++;
+        x |= (byte & 0x7f) << shift;
+        if (byte < 0x80) {
+            return x;
+        }
+    }
+}
+
+/*
+ * @function: zigzag / unzigzag
+ * @purpose: Map a signed difference to an unsigned one and back, so
+ * small steps backwards encode as short varints too.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: delta - A difference (int32_t), x - Its zigzag code
+ * (uint32_t).
+ *
+ * @returns: The code, or the difference it encodes.
+ */
+
+inline uint32_t CompactGraph::zigzag(int32_t delta)
+{
+    return (static_cast<uint32_t>(delta) << 1) ^
+           static_cast<uint32_t>(delta >> 31);
+}
+
+inline int32_t CompactGraph::unzigzag(uint32_t x)
+{
+    return static_cast<int32_t>((x >> 1) ^ (0u - (x & 1)));
+}
+
+template <typename Visit>
+bool CompactGraph::for_each_neighbor(VertexId v, Visit visit) const
+{
+    if (isBipartite) {
+        std::vector<std::pair<VertexId, SongId>> list;
+        collaborators(v, list);
+        for (const std::pair<VertexId, SongId> &edge : list) {
+            if (not visit(edge.first, edge.second)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (not isCompressed) {
+        const SongId *song = songs_begin(v);
+        for (const VertexId *n = neighbors_begin(v);
+                              n != neighbors_end(v); n++, song++) {
+            if (not visit(*n, *song)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const uint8_t *p   = packed.data() + packedOffsets[v];
+    const uint8_t *end = packed.data() + packedOffsets[v + 1];
+    const uint8_t *run = songRuns.data() + songRunOffsets[v];
+    VertexId neighbor = v;
+    SongId   song = 0;
+    uint32_t runLeft = 0;
+    while (p != end) {
+        if (runLeft == 0) {
+            song += unzigzag(read_varint(run));
+            runLeft = read_varint(run);
+        }
+        runLeft--;
+        neighbor += unzigzag(read_varint(p));
+        if (not visit(neighbor, song)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Visit>
+bool CompactGraph::for_each_neighbor_id(VertexId v, Visit visit) const
+{
+    if (isBipartite) {
+        std::vector<VertexId> list;
+        collaborator_ids(v, list);
+        for (VertexId n : list) {
+            if (not visit(n)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (not isCompressed) {
+        for (const VertexId *n = neighbors_begin(v);
+                              n != neighbors_end(v); n++) {
+            if (not visit(*n)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const uint8_t *p   = packed.data() + packedOffsets[v];
+    const uint8_t *end = packed.data() + packedOffsets[v + 1];
+    VertexId neighbor = v;
+    while (p != end) {
+        neighbor += unzigzag(read_varint(p));
+        if (not visit(neighbor)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif /* __COMPACT_GRAPH__ */
@@ -0,0 +1,150 @@
+/*
+ * DataLoader.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Read a dataFile into Artist instances, and report how long
+ *   loading took and how much memory it used.
+ */
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "DataLoader.h"
+#include "Artist.h"
+
+using namespace std;
+
+/*
+ * @function: readArtists
+ * @purpose: Parses the artist records in a dataFile, all of them or
+ * the next batch.
+ *
+ * @preconditions: 'in' is open, and positioned at the start of a
+ * record.
+ *
+ * @postconditions: One Artist per record is appended to 'artistList',
+ * in the order the records appear. With a 'limit', reading stops
+ * right after that many records, so a later call picks up at the
+ * next one; 'in' fails once the file is used up.
+ *
+ * @parameters: in - The dataFile (istream&), artistList - Where the
+ * artists are stored (vector<unique_ptr<Artist>>&), limit - The most
+ * records to read, or 0 for all of them (size_t).
+ *
+ * @returns: The number of bytes read from 'in' (size_t).
+ */
+
+size_t readArtists(istream &in, vector<unique_ptr<Artist>> &artistList,
+                   size_t limit)
+{
+    string line;
+    unique_ptr<Artist> curArtist;
+    bool nameSet = false;
+    size_t bytesRead = 0;
+    size_t records = 0;
+    while ((limit == 0 or records < limit) and getline(in, line)) {
+        /* the newline is consumed too, unless the file ends without one */
+        bytesRead += line.size() + (in.eof() ? 0 : 1);
+        if (line != "*") {
+            if (!nameSet) {
+                curArtist = make_unique<Artist>();
+                curArtist->set_name(line);
+                nameSet = true;
+            } else {
+                curArtist->add_song(line);
+            }
+        } else {
+            nameSet = false;
+            artistList.push_back(std::move(curArtist));
+            curArtist = make_unique<Artist>();
+            records++;
+        }
+    }
+    if (nameSet) {
+        artistList.push_back(std::move(curArtist));
+    }
+    return bytesRead;
+}
+
+/*
+ * @function: peakRssBytes
+ * @purpose: Reports the most physical memory the process has held.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: The peak resident set size in bytes, or 0 if it is not
+ * available (size_t).
+ */
+
+size_t peakRssBytes()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+}
+
+/*
+ * @function: printLoadProfile
+ * @purpose: Prints where the time and memory of loading went.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: out - Where to print (ostream&), profile - The
+ * measurements (const LoadProfile&).
+ *
+ * @returns: None.
+ */
+
+void printLoadProfile(ostream &out, const LoadProfile &profile)
+{
+    const double MiB = 1024.0 * 1024.0;
+    double total = profile.parseMs + profile.insertMs + profile.edgeMs +
+                   profile.packMs + profile.indexMs;
+
+    /* the stream is shared (--metrics may write to it), so leave its
+     * format as it was */
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+    out << fixed << setprecision(2) << "load profile";
+    /* a streaming load publishes several versions */
+    if (profile.version > 1) {
+        out << " (version " << profile.version << ")";
+    }
+    out << ": " << profile.artists << " artists, ";
+    if (profile.credits > 0) {
+        out << profile.credits << " song credits\n";
+    } else {
+        out << profile.edges << " collaborations\n";
+    }
+    out << "  bytes read     " << setw(12) << profile.bytesRead << "\n"
+        << "  parse          " << setw(12) << profile.parseMs << " ms\n"
+        << "  vertex insert  " << setw(12) << profile.insertMs << " ms\n"
+        << "  edge build     " << setw(12) << profile.edgeMs << " ms\n"
+        << "  pack           " << setw(12) << profile.packMs << " ms\n"
+        << "  name index     " << setw(12) << profile.indexMs << " ms\n"
+        << "  total          " << setw(12) << total << " ms\n"
+        << "  peak RSS       " << setw(12) << profile.peakRssBytes / MiB
+        << " MiB\n"
+        << "  CollabGraph    " << setw(12) << profile.collabBytes / MiB
+        << " MiB\n"
+        << "  CompactGraph   " << setw(12) << profile.compactBytes / MiB
+        << " MiB\n"
+        << "  SongCredits    " << setw(12) << profile.creditBytes / MiB
+        << " MiB" << endl;
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,48 @@
+/*
+ * DataLoader.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Read a dataFile into Artist instances. A dataFile lists each
+ *   artist's name on one line, one song per line after it, and a
+ *   line holding only "*" after the last song.
+ *
+ *   Also the load-phase breakdown printed by --profile-load.
+ */
+#ifndef __DATA_LOADER__
+#define __DATA_LOADER__
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "Artist.h"
+
+size_t readArtists(std::istream &in,
+                   std::vector<std::unique_ptr<Artist>> &artistList,
+                   size_t limit = 0);
+
+/* where startup time and memory go; times are in milliseconds */
+struct LoadProfile {
+    size_t bytesRead    = 0;
+    size_t artists      = 0;
+    size_t edges        = 0;
+    size_t credits      = 0;     /* bipartite graphs count these instead */
+    double parseMs      = 0;
+    double insertMs     = 0;     /* CollabGraph::insert_vertex */
+    double edgeMs       = 0;     /* SixDegrees::setEdges */
+    double packMs       = 0;     /* CompactGraph build, reorder, compress,
+                                  * SongCredits */
+    double indexMs      = 0;     /* NameMatcher, when enabled */
+    size_t collabBytes  = 0;     /* held by the CollabGraph */
+    size_t compactBytes = 0;     /* held by the CompactGraph */
+    size_t creditBytes  = 0;     /* held by the SongCredits */
+    size_t peakRssBytes = 0;
+    size_t version      = 0;     /* graph versions published so far */
+};
+
+size_t peakRssBytes();
+void   printLoadProfile(std::ostream &out, const LoadProfile &profile);
+
+#endif /* __DATA_LOADER__ */
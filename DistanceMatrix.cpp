@@ -0,0 +1,403 @@
+/*
+ * DistanceMatrix.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Bit-parallel multi-source breadth-first search and the two file
+ *   formats the matrix command writes.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include "DistanceMatrix.h"
+#include "Parallel.h"
+
+using namespace std;
+
+typedef CompactGraph::VertexId VertexId;
+typedef CompactGraph::SongId   SongId;
+
+namespace {
+
+const size_t   BATCH     = 64;
+const uint32_t NO_COLUMN = UINT32_MAX;
+
+/* the columns of listed artist v are first[v], next[first[v]], ...
+ * until NO_COLUMN; an artist listed twice has two columns */
+struct Columns {
+    vector<uint32_t> first;
+    vector<uint32_t> next;
+};
+
+/* what may end the search early: a token, a deadline, or neither */
+struct Limits {
+    const StopToken *stop;
+    bool hasDeadline;
+    chrono::steady_clock::time_point deadline;
+
+    StopReason check() const
+    {
+        if (stop != nullptr and stop->cancelled()) {
+            return StopReason::CANCELLED;
+        }
+        if (hasDeadline and chrono::steady_clock::now() >= deadline) {
+            return StopReason::BUDGET;
+        }
+        return StopReason::NONE;
+    }
+};
+
+/* one thread's search state, reused from batch to batch; bit i of a
+ * vertex's word stands for the batch's i-th source */
+struct BatchState {
+    vector<uint64_t> seen;        /* sources that have reached v */
+    vector<uint64_t> frontier;    /* ... first reached v last level */
+    vector<uint64_t> next;        /* ... reach v this level */
+    vector<uint64_t> songBits;    /* bipartite: ... reach song s */
+    vector<VertexId> active;      /* vertices with a nonzero frontier */
+    vector<VertexId> touched;     /* vertices with a nonzero next */
+    vector<SongId>   songsTouched;
+
+    explicit BatchState(const CompactGraph &graph)
+        : seen(graph.vertex_count()), frontier(graph.vertex_count()),
+          next(graph.vertex_count()),
+          songBits(graph.is_bipartite() ? graph.song_count() : 0)
+    {
+    }
+};
+
+/*
+ * @function: reach
+ * @purpose: Carries the searches in 'bits' to vertex v.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: The bits v has not seen are added to its next
+ * word, and v is listed as touched the first time that happens.
+ *
+ * @parameters: state - The thread's search (BatchState&), v - The
+ * vertex reached (VertexId), bits - The searches reaching it
+ * (uint64_t).
+ *
+ * @returns: None.
+ */
+
+inline void reach(BatchState &state, VertexId v, uint64_t bits)
+{
+    bits &= ~state.seen[v];
+    if (bits == 0) {
+        return;
+    }
+    if (state.next[v] == 0) {
+        state.touched.push_back(v);
+    }
+    state.next[v] |= bits;
+}
+
+/*
+ * @function: push
+ * @purpose: Expands one level of every search in the batch at once.
+ *
+ * @preconditions: 'state.active' lists the vertices reached last
+ * level; 'touched' is empty.
+ *
+ * @postconditions: Every neighbor of an active vertex has received
+ * the vertex's frontier bits (see reach). In a bipartite graph the
+ * bits are gathered per song first, so each song's members are
+ * walked once per level however many active artists it credits.
+ *
+ * @parameters: graph - The graph (const CompactGraph&), state - The
+ * thread's search (BatchState&).
+ *
+ * @returns: None.
+ */
+
+void push(const CompactGraph &graph, BatchState &state)
+{
+    if (not graph.is_bipartite()) {
+        for (VertexId u : state.active) {
+            uint64_t bits = state.frontier[u];
+            graph.for_each_neighbor_id(u, [&](VertexId v) {
+                reach(state, v, bits);
+                return true;
+            });
+        }
+        return;
+    }
+
+    for (VertexId u : state.active) {
+        uint64_t bits = state.frontier[u];
+        for (const SongId *s = graph.credits_begin(u);
+                           s != graph.credits_end(u); s++) {
+            if (state.songBits[*s] == 0) {
+                state.songsTouched.push_back(*s);
+            }
+            state.songBits[*s] |= bits;
+        }
+    }
+    for (SongId s : state.songsTouched) {
+        uint64_t bits = state.songBits[s];
+        state.songBits[s] = 0;
+        for (const VertexId *v = graph.members_begin(s);
+                             v != graph.members_end(s); v++) {
+            reach(state, *v, bits);
+        }
+    }
+    state.songsTouched.clear();
+}
+
+/*
+ * @function: search_batch
+ * @purpose: Fills rows [first, first + count) of the matrix.
+ *
+ * @preconditions: 'count' is at most 64, those rows hold UNREACHABLE,
+ * and 'state' is clear (as a new one or the last call left it).
+ *
+ * @postconditions: Each row holds the distances from its artist to
+ * every listed artist, unless 'limits' ended the search between two
+ * levels; 'state' is clear again either way.
+ *
+ * @parameters: graph - The graph (const CompactGraph&), ids - The
+ * listed artists (const vector<VertexId>&), columns - Where each is
+ * listed (const Columns&), first, count - The rows (size_t), state -
+ * The thread's search (BatchState&), distances - The matrix
+ * (vector<Distance>&), limits - What may end the search early
+ * (const Limits&).
+ *
+ * @returns: Why the search ended early, or NONE (StopReason).
+ */
+
+StopReason search_batch(const CompactGraph &graph,
+                        const vector<VertexId> &ids, const Columns &columns,
+                        size_t first, size_t count, BatchState &state,
+                        vector<Distance> &distances, const Limits &limits)
+{
+    StopReason stopped = StopReason::NONE;
+    size_t n = ids.size();
+    size_t remaining = count * n;
+    auto record = [&](VertexId v, uint64_t bits, Distance level) {
+        for (uint32_t c = columns.first[v]; c != NO_COLUMN;
+                                            c = columns.next[c]) {
+            for (uint64_t b = bits; b != 0; b &= b - 1) {
+                size_t row = first + __builtin_ctzll(b);
+                distances[row * n + c] = level;
+                remaining--;
+            }
+        }
+    };
+
+    for (size_t i = 0; i < count; i++) {
+        VertexId v = ids[first + i];
+        if (state.frontier[v] == 0) {
+            state.active.push_back(v);
+        }
+        state.frontier[v] |= uint64_t(1) << i;
+        state.seen[v] = state.frontier[v];
+    }
+    for (VertexId v : state.active) {
+        record(v, state.frontier[v], 0);
+    }
+
+    for (Distance level = 1; remaining > 0 and not state.active.empty()
+                             and level != UNREACHABLE; level++) {
+        stopped = limits.check();
+        if (stopped != StopReason::NONE) {
+            break;
+        }
+        push(graph, state);
+        for (VertexId u : state.active) {
+            state.frontier[u] = 0;
+        }
+        state.active.clear();
+
+        for (VertexId v : state.touched) {
+            uint64_t bits = state.next[v];
+            state.next[v] = 0;
+            state.seen[v] |= bits;
+            state.frontier[v] = bits;
+            state.active.push_back(v);
+            record(v, bits, level);
+        }
+        state.touched.clear();
+    }
+
+    for (VertexId u : state.active) {
+        state.frontier[u] = 0;
+    }
+    state.active.clear();
+    fill(state.seen.begin(), state.seen.end(), 0);
+    return stopped;
+}
+
+/* little-endian fields of the binary format */
+void put32(ostream &out, uint32_t x)
+{
+    char bytes[4] = { char(x), char(x >> 8), char(x >> 16), char(x >> 24) };
+    out.write(bytes, sizeof bytes);
+}
+
+void put16(ostream &out, uint16_t x)
+{
+    char bytes[2] = { char(x), char(x >> 8) };
+    out.write(bytes, sizeof bytes);
+}
+
+/* a CSV field: quoted, with quotes doubled */
+void put_name(ostream &out, string_view name)
+{
+    out << '"';
+    for (char c : name) {
+        if (c == '"') {
+            out << '"';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+}
+
+/*
+ * @function: distance_matrix
+ * @purpose: Computes the degrees of separation between every pair of
+ * listed artists.
+ *
+ * @preconditions: Every id is less than graph.vertex_count(), and
+ * 'threads' is at least 1.
+ *
+ * @postconditions: 'distances' holds ids.size() rows of ids.size()
+ * distances, row i from ids[i], as bfs would count them except that an
+ * artist is 0 from itself. Pairs with no path, or none shorter than
+ * UNREACHABLE, are UNREACHABLE.
+ *
+ * @parameters: graph - The graph (const CompactGraph&), ids - The
+ * listed artists, in matrix order (const vector<VertexId>&), threads -
+ * How many batches may run at once (size_t), distances - Receives the
+ * matrix (vector<Distance>&), stop - Cancels the search, or nullptr
+ * (const StopToken*), deadlineMs - How long it may run, 0 for no
+ * limit (size_t).
+ *
+ * @returns: CANCELLED or BUDGET if the search was ended early, in
+ * which case the matrix is incomplete, NONE otherwise (StopReason).
+ */
+
+StopReason distance_matrix(const CompactGraph &graph,
+                           const vector<VertexId> &ids, size_t threads,
+                           vector<Distance> &distances,
+                           const StopToken *stop, size_t deadlineMs)
+{
+    Limits limits { stop, deadlineMs != 0,
+                    chrono::steady_clock::now() +
+                    chrono::milliseconds(deadlineMs) };
+    atomic<StopReason> stopped { StopReason::NONE };
+
+    size_t n = ids.size();
+    distances.assign(n * n, UNREACHABLE);
+
+    Columns columns;
+    columns.first.assign(graph.vertex_count(), NO_COLUMN);
+    columns.next.assign(n, NO_COLUMN);
+    for (size_t c = n; c-- > 0; ) {
+        columns.next[c] = columns.first[ids[c]];
+        columns.first[ids[c]] = uint32_t(c);
+    }
+
+    size_t batches = (n + BATCH - 1) / BATCH;
+    size_t workers = max<size_t>(1, min(threads, batches));
+    parallel_ranges(batches, workers, [&](size_t begin, size_t end, size_t) {
+        BatchState state(graph);
+        for (size_t b = begin; b < end; b++) {
+            size_t first = b * BATCH;
+            StopReason reason = search_batch(graph, ids, columns, first,
+                                             min(BATCH, n - first), state,
+                                             distances, limits);
+            if (reason != StopReason::NONE) {
+                stopped = reason;
+                return;
+            }
+        }
+    });
+    return stopped;
+}
+
+/*
+ * @function: write_matrix_csv
+ * @purpose: Writes a matrix as comma-separated values.
+ *
+ * @preconditions: 'distances' came from distance_matrix(graph, ids).
+ *
+ * @postconditions: A header row names the columns after an empty
+ * cell, then each row starts with its artist's name. Names are
+ * quoted; unreachable pairs are empty cells.
+ *
+ * @parameters: out - Where the file goes (ostream&), graph - The graph
+ * (const CompactGraph&), ids - The listed artists (const
+ * vector<VertexId>&), distances - The matrix (const vector<Distance>&).
+ *
+ * @returns: None.
+ */
+
+void write_matrix_csv(ostream &out, const CompactGraph &graph,
+                      const vector<VertexId> &ids,
+                      const vector<Distance> &distances)
+{
+    size_t n = ids.size();
+    for (VertexId id : ids) {
+        out << ',';
+        put_name(out, graph.vertex_name(id));
+    }
+    out << '\n';
+
+    for (size_t i = 0; i < n; i++) {
+        put_name(out, graph.vertex_name(ids[i]));
+        for (size_t j = 0; j < n; j++) {
+            out << ',';
+            if (distances[i * n + j] != UNREACHABLE) {
+                out << distances[i * n + j];
+            }
+        }
+        out << '\n';
+    }
+}
+
+/*
+ * @function: write_matrix_binary
+ * @purpose: Writes a matrix in the compact binary format.
+ *
+ * @preconditions: 'distances' came from distance_matrix(graph, ids).
+ *
+ * @postconditions: The file is the four bytes "SDMX", the artist count
+ * n, each name as its length and bytes, then the n * n distances row
+ * by row, UNREACHABLE (0xffff) where there is no path. Counts and
+ * lengths are 32-bit and distances 16-bit, all little-endian.
+ *
+ * @parameters: out - Where the file goes, opened in binary mode
+ * (ostream&), graph - The graph (const CompactGraph&), ids - The
+ * listed artists (const vector<VertexId>&), distances - The matrix
+ * (const vector<Distance>&).
+ *
+ * @returns: None.
+ */
+
+void write_matrix_binary(ostream &out, const CompactGraph &graph,
+                         const vector<VertexId> &ids,
+                         const vector<Distance> &distances)
+{
+    out.write("SDMX", 4);
+    put32(out, uint32_t(ids.size()));
+    for (VertexId id : ids) {
+        string_view name = graph.vertex_name(id);
+        put32(out, uint32_t(name.size()));
+        out.write(name.data(), name.size());
+    }
+    for (Distance d : distances) {
+        put16(out, d);
+    }
+}
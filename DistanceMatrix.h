@@ -0,0 +1,52 @@
+/*
+ * DistanceMatrix.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   All-pairs degrees of separation for a list of artists, as the
+ *   matrix command reports them.
+ *
+ *   Instead of one breadth-first search per listed artist, the sources
+ *   are searched 64 at a time (Then et al., "The More the Merrier",
+ *   VLDB 2015): every vertex has a word whose bit i says source i has
+ *   reached it, so one pass over an edge carries up to 64 searches
+ *   across it at once. Each level, the active vertices push their new
+ *   bits to their neighbors (through their songs in a bipartite
+ *   graph); a neighbor whose bits include some it has not seen before
+ *   is active in the next level, and those bits are its distances.
+ *   A batch stops when every one of its sources has reached every
+ *   listed artist, or when nothing new was reached.
+ *
+ *   Batches are independent, so they are split across threads, each
+ *   writing its own rows of the matrix.
+ */
+#ifndef __DISTANCE_MATRIX__
+#define __DISTANCE_MATRIX__
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "CompactGraph.h"
+#include "Traversal.h"
+
+/* distances[i * ids.size() + j] is the number of collaborations on a
+ * shortest path from ids[i] to ids[j], or UNREACHABLE */
+typedef uint16_t Distance;
+const Distance UNREACHABLE = UINT16_MAX;
+
+StopReason distance_matrix(const CompactGraph &graph,
+                           const std::vector<CompactGraph::VertexId> &ids,
+                           size_t threads, std::vector<Distance> &distances,
+                           const StopToken *stop = nullptr,
+                           size_t deadlineMs = 0);
+
+void write_matrix_csv(std::ostream &out, const CompactGraph &graph,
+                      const std::vector<CompactGraph::VertexId> &ids,
+                      const std::vector<Distance> &distances);
+void write_matrix_binary(std::ostream &out, const CompactGraph &graph,
+                         const std::vector<CompactGraph::VertexId> &ids,
+                         const std::vector<Distance> &distances);
+
+#endif /* __DISTANCE_MATRIX__ */
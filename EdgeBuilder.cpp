@@ -0,0 +1,309 @@
+/*
+ * EdgeBuilder.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Parallel construction of the collaboration edges from a song index.
+ */
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "EdgeBuilder.h"
+#include "Parallel.h"
+
+using namespace std;
+
+namespace {
+
+/* artists whose later collaborators are found together */
+const size_t CHUNK = 256;
+
+/*
+ * The later collaborators of the artists in one chunk, artist by
+ * artist, each artist's sorted by partner.
+ */
+struct UpperChunk {
+    vector<uint32_t>       partners;
+    vector<const string *> songs;
+};
+
+/* a song of an artist, by its position in the discography */
+struct SongRef {
+    uint32_t artist, position;
+};
+
+/* a collaboration seen from its later artist */
+struct LowerEdge {
+    uint32_t       from, to;
+    const string  *song;
+};
+
+/*
+ * @function: bucketStarts
+ * @purpose: Turns per-thread bucket sizes into where each thread
+ * writes its share of each bucket.
+ *
+ * @preconditions: sizes[b * threads + t] is how many items thread t
+ * puts in bucket b.
+ *
+ * @postconditions: sizes[b * threads + t] is where thread t writes
+ * its first item of bucket b, so each bucket holds thread 0's items,
+ * then thread 1's, and so on; bucket b is [sizes[b * threads],
+ * sizes[(b + 1) * threads]). The total is appended.
+ *
+ * @parameters: sizes - The sizes (vector<size_t>&).
+ *
+ * @returns: The number of items (size_t).
+ */
+
+size_t bucketStarts(vector<size_t> &sizes)
+{
+    size_t total = 0;
+    for (size_t &size : sizes) {
+        size_t count = size;
+        size = total;
+        total += count;
+    }
+    sizes.push_back(total);
+    return total;
+}
+
+}
+
+/*
+ * @function: buildCollabEdges
+ * @purpose: Finds every collaboration in a dataset, the way setEdges
+ * would, using 'threads' threads.
+ *
+ * @preconditions: The artists outlive 'edges'.
+ *
+ * @postconditions: If true is returned, 'edges' holds the adjacency
+ * lists setEdges would build, in the same order and with the same
+ * songs. Datasets where setEdges depends on more than the first shared
+ * song (two artists with the same name, or a blank song title) are not
+ * handled; false is returned and 'edges' should be ignored.
+ *
+ * @parameters: artists - The artists, in the order setEdges would see
+ * them (const vector<Artist*>&), threads - How many threads to use
+ * (size_t), edges - Filled with the adjacency (CollabEdges&).
+ *
+ * @returns: True iff the edges were built.
+ */
+
+bool buildCollabEdges(const vector<Artist *> &artists, size_t threads,
+                      CollabEdges &edges)
+{
+    size_t n = artists.size();
+    threads = max<size_t>(1, min(threads, max<size_t>(n / CHUNK, 1)));
+    hash<string_view> hasher;
+
+    /* 1. hash every name and song */
+    vector<size_t> songStart(n + 1, 0);
+    for (size_t u = 0; u < n; u++) {
+        songStart[u + 1] = songStart[u] + artists[u]->get_discography().size();
+    }
+    vector<size_t> nameHash(n);
+    vector<size_t> songHash(songStart[n]);
+    atomic<bool> blankSong(false);
+
+    parallel_ranges(n, threads, [&](size_t begin, size_t end, size_t) {
+        for (size_t u = begin; u < end; u++) {
+            nameHash[u] = hasher(artists[u]->get_name());
+            const vector<string> &songs = artists[u]->get_discography();
+            for (size_t p = 0; p < songs.size(); p++) {
+                if (songs[p].empty()) {
+                    blankSong = true;
+                }
+                songHash[songStart[u] + p] = hasher(songs[p]);
+            }
+        }
+    });
+    if (blankSong) {
+        return false;
+    }
+
+    /* 2. one shard of the song index (and of the name check) per
+     * thread. The songs and names are first bucketed by shard in
+     * artist order (count, sum, scatter), so each is read once; the
+     * postings of every song then ascend */
+    vector<size_t> songAt(threads * threads, 0);
+    vector<size_t> nameAt(threads * threads, 0);
+    parallel_ranges(n, threads, [&](size_t begin, size_t end, size_t t) {
+        for (size_t u = begin; u < end; u++) {
+            nameAt[nameHash[u] % threads * threads + t]++;
+            for (size_t s = songStart[u]; s < songStart[u + 1]; s++) {
+                songAt[songHash[s] % threads * threads + t]++;
+            }
+        }
+    });
+    vector<SongRef>  songBuckets(bucketStarts(songAt));
+    vector<uint32_t> nameBuckets(bucketStarts(nameAt));
+
+    parallel_ranges(n, threads, [&](size_t begin, size_t end, size_t t) {
+        vector<size_t> songSlot(threads), nameSlot(threads);
+        for (size_t shard = 0; shard < threads; shard++) {
+            songSlot[shard] = songAt[shard * threads + t];
+            nameSlot[shard] = nameAt[shard * threads + t];
+        }
+        for (size_t u = begin; u < end; u++) {
+            nameBuckets[nameSlot[nameHash[u] % threads]++] = u;
+            for (size_t s = songStart[u]; s < songStart[u + 1]; s++) {
+                songBuckets[songSlot[songHash[s] % threads]++] =
+                    SongRef { uint32_t(u), uint32_t(s - songStart[u]) };
+            }
+        }
+    });
+
+    typedef unordered_map<string_view, vector<uint32_t>> SongIndex;
+    vector<SongIndex> index(threads);
+    atomic<bool> duplicateName(false);
+
+    parallel_ranges(threads, threads, [&](size_t, size_t, size_t shard) {
+        unordered_set<string_view> names;
+        for (size_t i = nameAt[shard * threads];
+                    i < nameAt[(shard + 1) * threads]; i++) {
+            if (not names.insert(artists[nameBuckets[i]]->get_name())
+                         .second) {
+                duplicateName = true;
+            }
+        }
+
+        SongIndex &songIndex = index[shard];
+        for (size_t i = songAt[shard * threads];
+                    i < songAt[(shard + 1) * threads]; i++) {
+            const SongRef &song = songBuckets[i];
+            const vector<string> &songs =
+                artists[song.artist]->get_discography();
+            songIndex[songs[song.position]].push_back(song.artist);
+        }
+    });
+    if (duplicateName) {
+        return false;
+    }
+
+    /* 3. later collaborators of each artist, first song wins */
+    vector<UpperChunk> chunks((n + CHUNK - 1) / CHUNK);
+    vector<uint32_t> upperCount(n, 0);
+    vector<size_t>   upperBegin(n, 0);
+    atomic<size_t>   nextChunk(0);
+
+    parallel_ranges(threads, threads, [&](size_t, size_t, size_t) {
+        vector<pair<uint32_t, uint32_t>> found;   /* (partner, song) */
+        for (size_t c = nextChunk++; c < chunks.size(); c = nextChunk++) {
+            UpperChunk &chunk = chunks[c];
+            size_t last = min(n, (c + 1) * CHUNK);
+            for (size_t u = c * CHUNK; u < last; u++) {
+                const vector<string> &songs = artists[u]->get_discography();
+                found.clear();
+                for (size_t p = 0; p < songs.size(); p++) {
+                    size_t shard = songHash[songStart[u] + p] % threads;
+                    for (uint32_t v : index[shard].at(songs[p])) {
+                        if (v > u) {
+                            found.emplace_back(v, p);
+                        }
+                    }
+                }
+
+                /* by partner, then by position in u's discography, so
+                 * the first entry per partner is the first shared song */
+                sort(found.begin(), found.end());
+                upperBegin[u] = chunk.partners.size();
+                for (size_t i = 0; i < found.size(); i++) {
+                    if (i > 0 and found[i].first == found[i - 1].first) {
+                        continue;
+                    }
+                    chunk.partners.push_back(found[i].first);
+                    chunk.songs.push_back(&songs[found[i].second]);
+                }
+                upperCount[u] = chunk.partners.size() - upperBegin[u];
+            }
+        }
+    });
+
+    /* 4. each thread owns a span of artists and assembles their
+     * lists. The collaborations found in step 3 are bucketed by the
+     * owner of the later artist (count, sum, scatter), in artist
+     * order, so each owner reads only its own, earliest first */
+    size_t span = max<size_t>(1, (n + threads - 1) / threads);
+    vector<size_t> lowerAt(threads * threads, 0);
+    parallel_ranges(n, threads, [&](size_t begin, size_t end, size_t t) {
+        for (size_t u = begin; u < end; u++) {
+            const UpperChunk &chunk = chunks[u / CHUNK];
+            for (size_t i = upperBegin[u];
+                        i < upperBegin[u] + upperCount[u]; i++) {
+                lowerAt[chunk.partners[i] / span * threads + t]++;
+            }
+        }
+    });
+    vector<LowerEdge> lowerEdges(bucketStarts(lowerAt));
+
+    parallel_ranges(n, threads, [&](size_t begin, size_t end, size_t t) {
+        vector<size_t> slot(threads);
+        for (size_t owner = 0; owner < threads; owner++) {
+            slot[owner] = lowerAt[owner * threads + t];
+        }
+        for (size_t u = begin; u < end; u++) {
+            const UpperChunk &chunk = chunks[u / CHUNK];
+            for (size_t i = upperBegin[u];
+                        i < upperBegin[u] + upperCount[u]; i++) {
+                uint32_t v = chunk.partners[i];
+                lowerEdges[slot[v / span]++] =
+                    LowerEdge { uint32_t(u), v, chunk.songs[i] };
+            }
+        }
+    });
+
+    /* 4a. how many earlier collaborators each artist has */
+    vector<uint32_t> lowerCount(n, 0);
+    parallel_ranges(threads, threads, [&](size_t, size_t, size_t owner) {
+        for (size_t i = lowerAt[owner * threads];
+                    i < lowerAt[(owner + 1) * threads]; i++) {
+            lowerCount[lowerEdges[i].to]++;
+        }
+    });
+
+    edges.offsets.assign(n + 1, 0);
+    for (size_t v = 0; v < n; v++) {
+        edges.offsets[v + 1] = edges.offsets[v] + lowerCount[v] +
+                               upperCount[v];
+    }
+    edges.neighbors.resize(edges.offsets[n]);
+    edges.songs.resize(edges.offsets[n]);
+
+    /* 4b. assemble each list: earlier collaborators in list order,
+     * then the artist's own later collaborators */
+    parallel_ranges(threads, threads, [&](size_t, size_t, size_t owner) {
+        size_t begin = min(n, owner * span);
+        size_t end   = min(n, begin + span);
+        vector<size_t> cursor(edges.offsets.begin() + begin,
+                              edges.offsets.begin() + end);
+        for (size_t i = lowerAt[owner * threads];
+                    i < lowerAt[(owner + 1) * threads]; i++) {
+            const LowerEdge &edge = lowerEdges[i];
+            size_t &slot = cursor[edge.to - begin];
+            edges.neighbors[slot] = edge.from;
+            edges.songs[slot]     = edge.song;
+            slot++;
+        }
+
+        for (size_t u = begin; u < end; u++) {
+            const UpperChunk &chunk = chunks[u / CHUNK];
+            size_t slot = cursor[u - begin];
+            for (size_t i = upperBegin[u];
+                        i < upperBegin[u] + upperCount[u]; i++, slot++) {
+                edges.neighbors[slot] = chunk.partners[i];
+                edges.songs[slot]     = chunk.songs[i];
+            }
+        }
+    });
+    return true;
+}
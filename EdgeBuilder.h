@@ -0,0 +1,55 @@
+/*
+ * EdgeBuilder.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Builds the collaboration edges of a dataset on several threads,
+ *   producing exactly the adjacency lists SixDegrees::setEdges would.
+ *
+ *   setEdges visits artist pairs (i, j) in list order and adds an edge
+ *   the first time either artist's discography names a song the other
+ *   also has, using the first such song of artist min(i, j). So the
+ *   collaborators of an artist always end up in list order, and each
+ *   edge's song is decided from the earlier artist's discography.
+ *
+ *   The builder finds the same edges through a song index instead of
+ *   comparing every pair:
+ *     1. every song and name is hashed, in parallel over artists;
+ *     2. the song index and a duplicate-name check are built in
+ *        shards, one per thread, each owning the hashes that fall in it;
+ *     3. for each artist u, in parallel, the later artists it shares a
+ *        song with are collected, keeping the first song per partner
+ *        (first-song-wins, as in insert_edge), sorted by partner;
+ *     4. each thread owns a range of artists and assembles their lists
+ *        in one pass: earlier collaborators (in list order) followed by
+ *        the artist's own later collaborators.
+ *   Steps 2 and 4 first hand each thread its share of the songs or
+ *   collaborations: every thread counts what it found for each owner,
+ *   the counts are summed, and every thread copies its items into its
+ *   own slots of each owner's bucket. Each item is read once per step,
+ *   however many threads there are.
+ *   No step writes memory another thread writes, so nothing is locked.
+ */
+#ifndef __EDGE_BUILDER__
+#define __EDGE_BUILDER__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Artist.h"
+
+/* the collaborators of artist i (indices into the artist list) are
+ * neighbors[offsets[i] .. offsets[i + 1]), each with its song in
+ * 'songs', which points into the artists' discographies */
+struct CollabEdges {
+    std::vector<size_t>               offsets;
+    std::vector<uint32_t>             neighbors;
+    std::vector<const std::string *>  songs;
+};
+
+bool buildCollabEdges(const std::vector<Artist *> &artists, size_t threads,
+                      CollabEdges &edges);
+
+#endif /* __EDGE_BUILDER__ */
@@ -0,0 +1,277 @@
+/*
+ * FrontierKernel.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Scalar versions of the frontier filters and the expansion of one
+ *   artist for each graph layout.
+ */
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "FrontierKernel.h"
+#include "SongCredits.h"
+#include "Traversal.h"
+
+typedef CompactGraph::VertexId VertexId;
+typedef CompactGraph::SongId   SongId;
+
+/*
+ * @function: filter_unvisited_scalar
+ * @purpose: Portable version of the unvisited-neighbor filter.
+ *
+ * @preconditions: 'out' has room for (end - begin) ids.
+ *
+ * @postconditions: The unvisited ids are at the front of 'out'.
+ *
+ * @parameters: begin, end - An adjacency list (const VertexId*),
+ * visited - The visited bitmap (const uint32_t*), out - Where the
+ * unvisited ids go (VertexId*).
+ *
+ * @returns: The number of unvisited ids (size_t).
+ */
+
+size_t filter_unvisited_scalar(const VertexId *begin, const VertexId *end,
+                               const uint32_t *visited, VertexId *out)
+{
+    size_t found = 0;
+    for (const VertexId *n = begin; n != end; n++) {
+        out[found] = *n;
+        found += ((visited[*n >> 5] >> (*n & 31)) & 1) ^ 1;
+    }
+    return found;
+}
+
+/*
+ * @function: filter_unvisited
+ * @purpose: Runs the filter searches use: the scalar one. At -O2 the
+ * AVX2 filter measured no faster (kernel_bench: level on a dataset of
+ * degree 21, 2-17% slower at degree 6), since most lists are too
+ * short for eight lanes to pay for the gathers.
+ *
+ * @preconditions: 'out' has room for (end - begin) + FILTER_SLACK ids.
+ *
+ * @postconditions: The unvisited ids are at the front of 'out'.
+ *
+ * @parameters: begin, end - An adjacency list (const VertexId*),
+ * visited - The visited bitmap (const uint32_t*), out - Where the
+ * unvisited ids go (VertexId*).
+ *
+ * @returns: The number of unvisited ids (size_t).
+ */
+
+size_t filter_unvisited(const VertexId *begin, const VertexId *end,
+                        const uint32_t *visited, VertexId *out)
+{
+    return filter_unvisited_scalar(begin, end, visited, out);
+}
+
+/*
+ * @function: append_unvisited
+ * @purpose: Expands one vertex of a breadth-first search: appends its
+ * unvisited neighbors to the workspace frontier.
+ *
+ * @preconditions: 'ws' has been reset for 'graph'.
+ *
+ * @postconditions: The unvisited neighbors of 'v' are at the end of
+ * ws.frontier, in adjacency order. They are not marked; the caller
+ * visits them. Compressed and bipartite lists are decoded into
+ * ws.scratch first.
+ * The edges of 'v' are added to the workspace's edge count.
+ *
+ * @parameters: graph - The graph being searched (const CompactGraph&),
+ * v - The vertex to expand (VertexId), ws - The search state
+ * (TraversalWorkspace&), filter - The filter to run (UnvisitedFilter).
+ *
+ * @returns: The number of ids appended (size_t).
+ */
+
+size_t append_unvisited(const CompactGraph &graph, VertexId v,
+                        TraversalWorkspace &ws, UnvisitedFilter filter)
+{
+    const VertexId *begin;
+    const VertexId *end;
+    if (graph.is_compressed() or graph.is_bipartite()) {
+        ws.scratch.clear();
+        graph.for_each_neighbor_id(v, [&](VertexId n) {
+            ws.scratch.push_back(n);
+            return true;
+        });
+        begin = ws.scratch.data();
+        end   = begin + ws.scratch.size();
+    } else {
+        begin = graph.neighbors_begin(v);
+        end   = graph.neighbors_end(v);
+    }
+
+    ws.count_edges(end - begin);
+    size_t tail = ws.frontier.size();
+    ws.frontier.resize(tail + (end - begin) + FILTER_SLACK);
+    size_t found = filter(begin, end, ws.visited_bits(),
+                          ws.frontier.data() + tail);
+    ws.frontier.resize(tail + found);
+    return found;
+}
+
+/*
+ * @function: append_allowed
+ * @purpose: Expands one vertex of a song-filtered breadth-first
+ * search: appends its unvisited neighbors it shares an allowed song
+ * with to the workspace frontier.
+ *
+ * @preconditions: 'ws' has been reset for 'graph'; 'credits' was built
+ * for 'graph'; 'allowed' has a bit for every song id of 'credits' and
+ * 'marked' one, all clear, for every vertex of 'graph'.
+ *
+ * @postconditions: As append_unvisited, keeping only the neighbors
+ * credited with 'v' on a song whose bit is set in 'allowed', whichever
+ * song the graph records for the collaboration. The artists of the
+ * allowed songs of 'v' are marked, then the adjacency list of 'v' is
+ * read in order, whatever its layout, and the marks are cleared
+ * again; a bipartite graph's neighbors are the marked artists
+ * themselves, sorted.
+ *
+ * @parameters: graph - The graph being searched (const CompactGraph&),
+ * v - The vertex to expand (VertexId), ws - The search state
+ * (TraversalWorkspace&), credits - Who is on each song
+ * (const SongCredits&), allowed - The allowed-song bitmap
+ * (const uint32_t*), marked - A scratch bitmap over vertices
+ * (uint32_t*).
+ *
+ * @returns: The number of ids appended (size_t).
+ */
+
+size_t append_allowed(const CompactGraph &graph, VertexId v,
+                      TraversalWorkspace &ws, const SongCredits &credits,
+                      const uint32_t *allowed, uint32_t *marked)
+{
+    size_t edges = 0;
+    bool any = false;
+    for (const SongId *s = credits.songs_begin(v);
+                       s != credits.songs_end(v); s++) {
+        if (not ((allowed[*s >> 5] >> (*s & 31)) & 1)) {
+            continue;
+        }
+        for (const VertexId *n = credits.artists_begin(*s);
+                             n != credits.artists_end(*s); n++) {
+            edges++;
+            marked[*n >> 5] |= 1u << (*n & 31);
+        }
+        any = true;
+    }
+    ws.count_edges(edges);
+    if (not any) {
+        return 0;
+    }
+
+    size_t tail = ws.frontier.size();
+    if (graph.is_bipartite()) {
+        /* the marked artists are the neighbors; ascending is the
+         * pairwise order */
+        for (const SongId *s = credits.songs_begin(v);
+                           s != credits.songs_end(v); s++) {
+            for (const VertexId *n = credits.artists_begin(*s);
+                                 n != credits.artists_end(*s); n++) {
+                uint32_t bit = 1u << (*n & 31);
+                if ((marked[*n >> 5] & bit) and *n != v and
+                    not ws.is_visited(*n)) {
+                    ws.frontier.push_back(*n);
+                }
+                marked[*n >> 5] &= ~bit;
+            }
+        }
+        sort(ws.frontier.begin() + tail, ws.frontier.end());
+        return ws.frontier.size() - tail;
+    }
+
+    graph.for_each_neighbor_id(v, [&](VertexId n) {
+        if (((marked[n >> 5] >> (n & 31)) & 1) and not ws.is_visited(n)) {
+            ws.frontier.push_back(n);
+        }
+        return true;
+    });
+    for (const SongId *s = credits.songs_begin(v);
+                       s != credits.songs_end(v); s++) {
+        for (const VertexId *n = credits.artists_begin(*s);
+                             n != credits.artists_end(*s); n++) {
+            marked[*n >> 5] &= ~(1u << (*n & 31));
+        }
+    }
+    return ws.frontier.size() - tail;
+}
+
+/*
+ * @function: append_credited
+ * @purpose: Expands one vertex of a search over a bipartite graph:
+ * appends the unvisited artists of the songs of 'v' that no earlier
+ * vertex expanded.
+ *
+ * @preconditions: 'ws' has been reset for 'graph', which is bipartite;
+ * 'expanded' is nullptr or has a bit for every song id of 'graph', set
+ * for the songs this search has already expanded.
+ *
+ * @postconditions: As append_unvisited: the unvisited neighbors of 'v'
+ * are at the end of ws.frontier, in ascending order, which is the
+ * order of the pairwise layout. The songs of 'v' are marked in
+ * 'expanded'. A breadth-first search visits every artist of a song
+ * when it first expands it, so later expansions can skip the song; a
+ * depth-first search does not, and passes nullptr.
+ *
+ * @parameters: graph - The graph being searched (const CompactGraph&),
+ * v - The vertex to expand (VertexId), ws - The search state
+ * (TraversalWorkspace&), expanded - The expanded-song bitmap, or
+ * nullptr (uint32_t*).
+ *
+ * @returns: The number of ids appended (size_t).
+ */
+
+size_t append_credited(const CompactGraph &graph, VertexId v,
+                       TraversalWorkspace &ws, uint32_t *expanded)
+{
+    size_t tail = ws.frontier.size();
+    size_t edges = 0;
+    size_t sources = 0;
+    const SongId *last = graph.credits_end(v);
+    for (const SongId *s = graph.credits_begin(v); s != last; s++) {
+        if (expanded != nullptr) {
+            uint32_t bit = 1u << (*s & 31);
+            if (expanded[*s >> 5] & bit) {
+                continue;
+            }
+            expanded[*s >> 5] |= bit;
+        }
+
+        const VertexId *begin = graph.members_begin(*s);
+        const VertexId *end   = graph.members_end(*s);
+        size_t at = ws.frontier.size();
+        edges += end - begin;
+        if (end - begin < static_cast<ptrdiff_t>(FILTER_SLACK)) {
+            /* most songs have a handful of artists; not worth a
+             * vector pass */
+            for (const VertexId *n = begin; n != end; n++) {
+                if (not ws.is_visited(*n)) {
+                    ws.frontier.push_back(*n);
+                }
+            }
+        } else {
+            ws.frontier.resize(at + (end - begin) + FILTER_SLACK);
+            size_t found = filter_unvisited(begin, end, ws.visited_bits(),
+                                            ws.frontier.data() + at);
+            ws.frontier.resize(at + found);
+        }
+        sources += ws.frontier.size() > at;
+    }
+    ws.count_edges(edges);
+
+    /* each song's artists ascend; an artist on several of the songs
+     * was found once per song */
+    if (sources > 1) {
+        sort(ws.frontier.begin() + tail, ws.frontier.end());
+        ws.frontier.erase(unique(ws.frontier.begin() + tail,
+                                 ws.frontier.end()),
+                          ws.frontier.end());
+    }
+    return ws.frontier.size() - tail;
+}
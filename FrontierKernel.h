@@ -0,0 +1,76 @@
+/*
+ * FrontierKernel.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   The inner loop of breadth-first search: given an adjacency list,
+ *   find the neighbors whose bit is still clear in the visited bitmap.
+ *   Searches use a portable scalar version. An AVX2 version, which
+ *   tests eight neighbors at a time (gathering their bitmap words and
+ *   packing the unvisited ids together with a permutation table), is
+ *   in FrontierKernelAvx2.cpp and linked only into kernel_bench: at -O2
+ *   it measured no faster, since most adjacency lists are shorter than
+ *   a few vectors.
+ *
+ *   Song-filtered searches keep a search to (or away from) particular
+ *   songs without rebuilding the graph: the artists 'v' shares a song
+ *   set in an 'allowed' song bitmap with are marked from the snapshot's
+ *   song credits, and only the marked neighbors are kept. Two artists
+ *   may share several songs, and the graph records only one of them.
+ *
+ *   A bipartite graph is expanded artist -> song -> artist instead:
+ *   the same filter runs over the artists of each song, and a song is
+ *   expanded only by the first artist that reaches it, since that
+ *   expansion finds every one of its artists. The artists found are
+ *   sorted, which puts them in the order the pairwise layout would.
+ */
+#ifndef __FRONTIER_KERNEL__
+#define __FRONTIER_KERNEL__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "CompactGraph.h"
+#include "Traversal.h"
+
+class SongCredits;
+
+/* writes the ids in [begin, end) whose bit is clear in 'visited' to
+ * 'out', keeping their order, and returns how many were written.
+ * 'out' needs room for (end - begin) + FILTER_SLACK ids. */
+typedef size_t (*UnvisitedFilter)(const CompactGraph::VertexId *begin,
+                                  const CompactGraph::VertexId *end,
+                                  const uint32_t *visited,
+                                  CompactGraph::VertexId *out);
+
+const size_t FILTER_SLACK = 8;
+
+size_t filter_unvisited_scalar(const CompactGraph::VertexId *begin,
+                               const CompactGraph::VertexId *end,
+                               const uint32_t *visited,
+                               CompactGraph::VertexId *out);
+
+/* the filter searches use; scalar, which measured as fast as AVX2 */
+size_t filter_unvisited(const CompactGraph::VertexId *begin,
+                        const CompactGraph::VertexId *end,
+                        const uint32_t *visited,
+                        CompactGraph::VertexId *out);
+
+size_t append_unvisited(const CompactGraph &graph, CompactGraph::VertexId v,
+                        TraversalWorkspace &ws,
+                        UnvisitedFilter filter = filter_unvisited);
+
+/* append_unvisited, keeping the neighbors 'v' shares a song set in
+ * 'allowed' with; 'marked' is a clear bitmap over vertices it uses as
+ * scratch */
+size_t append_allowed(const CompactGraph &graph, CompactGraph::VertexId v,
+                      TraversalWorkspace &ws, const SongCredits &credits,
+                      const uint32_t *allowed, uint32_t *marked);
+
+/* append_unvisited for a bipartite graph; 'expanded' marks the songs
+ * a breadth-first search has already expanded (nullptr for none) */
+size_t append_credited(const CompactGraph &graph, CompactGraph::VertexId v,
+                       TraversalWorkspace &ws, uint32_t *expanded);
+
+#endif /* __FRONTIER_KERNEL__ */
@@ -0,0 +1,123 @@
+/*
+ * FrontierKernelAvx2.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   The AVX2 version of the unvisited-neighbor filter. This is the
+ *   only file the Makefile compiles with -mavx2, so the compiler may
+ *   use AVX2 here and nowhere else; simd_filter_available() decides at
+ *   runtime whether the filter may be called. No project header is
+ *   included: their inline functions and the static initializer of
+ *   <iostream> would be built for AVX2 too, and the linker could keep
+ *   those copies for the whole program.
+ *
+ *   Built without AVX2 (another architecture, or another compiler's
+ *   flags), the function falls back to the scalar filter and
+ *   avx2_filter_built is false.
+ */
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/* CompactGraph::VertexId; a mismatch with the declarations in
+ * FrontierKernel.h would fail to link */
+typedef uint32_t VertexId;
+
+size_t filter_unvisited_scalar(const VertexId *begin, const VertexId *end,
+                               const uint32_t *visited, VertexId *out);
+
+#ifdef __AVX2__
+
+extern const bool avx2_filter_built = true;
+
+/* for every 8-bit mask, the lanes whose bit is set, packed to the
+ * front; used to emulate a compressed store, which AVX2 lacks */
+struct CompressTable {
+    alignas(32) uint32_t lanes[256][8] = {};
+
+    /* constexpr, so no code built for AVX2 runs at startup */
+    constexpr CompressTable()
+    {
+        for (int mask = 0; mask < 256; mask++) {
+            int next = 0;
+            for (int lane = 0; lane < 8; lane++) {
+                if (mask & (1 << lane)) {
+                    lanes[mask][next++] = lane;
+                }
+            }
+            while (next < 8) {
+                lanes[mask][next++] = 0;
+            }
+        }
+    }
+};
+
+static constexpr CompressTable compressTable;
+
+/*
+ * @function: filter_unvisited_avx2
+ * @purpose: AVX2 version of the unvisited-neighbor filter.
+ *
+ * @preconditions: The CPU supports AVX2. 'out' has room for
+ * (end - begin) + FILTER_SLACK ids, since every store writes 8 lanes.
+ *
+ * @postconditions: The unvisited ids are at the front of 'out'.
+ *
+ * @parameters: begin, end - An adjacency list (const VertexId*),
+ * visited - The visited bitmap (const uint32_t*), out - Where the
+ * unvisited ids go (VertexId*).
+ *
+ * @returns: The number of unvisited ids (size_t).
+ */
+
+size_t filter_unvisited_avx2(const VertexId *begin, const VertexId *end,
+                             const uint32_t *visited, VertexId *out)
+{
+    const __m256i low5 = _mm256_set1_epi32(31);
+    const __m256i one  = _mm256_set1_epi32(1);
+    const __m256i zero = _mm256_setzero_si256();
+    size_t found = 0;
+    const VertexId *n = begin;
+
+    for (; end - n >= 8; n += 8) {
+        __m256i ids   = _mm256_loadu_si256(
+                            reinterpret_cast<const __m256i *>(n));
+        __m256i words = _mm256_i32gather_epi32(
+                            reinterpret_cast<const int *>(visited),
+                            _mm256_srli_epi32(ids, 5), 4);
+        __m256i bits  = _mm256_and_si256(
+                            _mm256_srlv_epi32(words,
+                                              _mm256_and_si256(ids, low5)),
+                            one);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(
+                            _mm256_cmpeq_epi32(bits, zero)));
+        if (mask == 0) {
+            continue;
+        }
+
+        __m256i lanes = _mm256_load_si256(
+                            reinterpret_cast<const __m256i *>(
+                                compressTable.lanes[mask]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + found),
+                            _mm256_permutevar8x32_epi32(ids, lanes));
+        found += _mm_popcnt_u32(mask);
+    }
+
+    return found + filter_unvisited_scalar(n, end, visited, out + found);
+}
+
+#else
+
+extern const bool avx2_filter_built = false;
+
+size_t filter_unvisited_avx2(const VertexId *begin, const VertexId *end,
+                             const uint32_t *visited, VertexId *out)
+{
+    return filter_unvisited_scalar(begin, end, visited, out);
+}
+
+#endif /* __AVX2__ */
@@ -0,0 +1,35 @@
+/*
+ * GraphSnapshot.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   One published version of what queries search: the packed graph,
+ *   the song credits the song-filtered searches read, and, when
+ *   configured, the name matcher built over the graph. A snapshot
+ *   never changes once published. SixDegrees publishes a new one by
+ *   swapping a shared_ptr atomically; each query takes the latest when
+ *   it starts and holds it until it finishes, so a query never sees
+ *   two versions, and a version is freed when the last query holding
+ *   it lets go.
+ */
+#ifndef __GRAPH_SNAPSHOT__
+#define __GRAPH_SNAPSHOT__
+
+#include <cstddef>
+#include <memory>
+
+#include "CompactGraph.h"
+#include "NameMatcher.h"
+#include "SongCredits.h"
+
+struct GraphSnapshot {
+    std::unique_ptr<CompactGraph> graph;
+    std::unique_ptr<SongCredits>  credits;
+    std::unique_ptr<NameMatcher>  matcher;
+    size_t version = 0;                     /* 1 for the first published */
+};
+
+typedef std::shared_ptr<const GraphSnapshot> SnapshotPtr;
+
+#endif /* __GRAPH_SNAPSHOT__ */
@@ -0,0 +1,171 @@
+/*
+ * NameIndex.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   A flat, Bloom-filtered name -> id table for frozen graphs.
+ */
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+#include "NameIndex.h"
+
+using namespace std;
+
+/*
+ * @constructor: NameIndex
+ * @purpose: Constructs an empty table whose arrays live in 'resource'.
+ *
+ * @preconditions: 'resource' outlives the table.
+ *
+ * @postconditions: Every lookup misses until build() is called.
+ *
+ * @parameters: resource - Where the arrays are allocated
+ * (pmr::memory_resource*).
+ *
+ * @returns: None.
+ */
+
+NameIndex::NameIndex(pmr::memory_resource *resource)
+    : names(nullptr), slots(resource), filter(resource),
+      slotMask(0), filterMask(0)
+{
+
+}
+
+/*
+ * @function: filter_bits
+ * @purpose: Picks the four filter bits of a name within its word.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: hash - 24 bits of the name's mixed hash (uint64_t).
+ *
+ * @returns: A word with up to four bits set (uint64_t).
+ */
+
+uint64_t NameIndex::filter_bits(uint64_t hash)
+{
+    return (uint64_t(1) << (hash & 63)) |
+           (uint64_t(1) << ((hash >> 6) & 63)) |
+           (uint64_t(1) << ((hash >> 12) & 63)) |
+           (uint64_t(1) << ((hash >> 18) & 63));
+}
+
+/*
+ * @function: build
+ * @purpose: Fills the table and filter with every name of a graph.
+ *
+ * @preconditions: 'names' outlives the table and does not change
+ * afterwards. The table is empty.
+ *
+ * @postconditions: find(names[i]) returns i; if a name appears more
+ * than once, its last position wins, as with an assignment into a map.
+ *
+ * @parameters: names - The artist names, by id
+ * (const pmr::vector<string_view>&).
+ *
+ * @returns: None.
+ */
+
+void NameIndex::build(const pmr::vector<string_view> &names)
+{
+    this->names = &names;
+
+    size_t slotCount = 2;
+    while (slotCount < 2 * names.size()) {
+        slotCount *= 2;
+    }
+    size_t filterWords = 1;
+    while (filterWords * 4 < names.size()) {
+        filterWords *= 2;
+    }
+    slots.assign(slotCount, Slot { 0, NO_VERTEX });
+    filter.assign(filterWords, 0);
+    slotMask = slotCount - 1;
+    filterMask = filterWords - 1;
+
+    hash<string_view> hasher;
+    for (VertexId id = 0; id < names.size(); id++) {
+        uint64_t h = hasher(names[id]);
+        uint64_t mixed = h * 0x9e3779b97f4a7c15ULL;
+        filter[(mixed >> 16) & filterMask] |= filter_bits(mixed >> 40);
+
+        uint32_t tag = h >> 32;
+        size_t i = h & slotMask;
+        while (slots[i].id != NO_VERTEX and
+               not (slots[i].tag == tag and
+                    names[slots[i].id] == names[id])) {
+            i = (i + 1) & slotMask;
+        }
+        slots[i] = Slot { tag, id };
+    }
+}
+
+/*
+ * @function: may_contain
+ * @purpose: Asks the Bloom filter whether a name could be in the
+ * table.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: name - The name to test (string_view).
+ *
+ * @returns: False if the name is certainly not in the table; true if
+ * it may be (bool).
+ */
+
+bool NameIndex::may_contain(string_view name) const
+{
+    if (filter.empty()) {
+        return false;
+    }
+    uint64_t mixed = hash<string_view>()(name) * 0x9e3779b97f4a7c15ULL;
+    uint64_t bits = filter_bits(mixed >> 40);
+    return (filter[(mixed >> 16) & filterMask] & bits) == bits;
+}
+
+/*
+ * @function: find
+ * @purpose: Looks up the id of a name.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: name - The name to look up (string_view).
+ *
+ * @returns: The name's id, or NO_VERTEX if it is not in the table
+ * (VertexId).
+ */
+
+NameIndex::VertexId NameIndex::find(string_view name) const
+{
+    if (filter.empty()) {
+        return NO_VERTEX;
+    }
+
+    uint64_t h = hash<string_view>()(name);
+    uint64_t mixed = h * 0x9e3779b97f4a7c15ULL;
+    uint64_t bits = filter_bits(mixed >> 40);
+    if ((filter[(mixed >> 16) & filterMask] & bits) != bits) {
+        return NO_VERTEX;
+    }
+
+    uint32_t tag = h >> 32;
+    for (size_t i = h & slotMask; slots[i].id != NO_VERTEX;
+                                  i = (i + 1) & slotMask) {
+        if (slots[i].tag == tag and (*names)[slots[i].id] == name) {
+            return slots[i].id;
+        }
+    }
+    return NO_VERTEX;
+}
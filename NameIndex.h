@@ -0,0 +1,57 @@
+/*
+ * NameIndex.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   The name -> id tables of a frozen CompactGraph (one for artists,
+ *   one for song titles). Since the names never change once the graph
+ *   is packed, each table is built in one go as a flat open-addressing
+ *   array (linear probing, at most half full) instead of a node-based
+ *   std::unordered_map. Each slot holds the id and the upper half of
+ *   the name's hash, so a lookup reads one or two adjacent slots and
+ *   only compares strings when the hashes agree.
+ *
+ *   Names that are not in the graph are usually turned away before the
+ *   table is probed at all by a blocked Bloom filter: each name sets
+ *   four bits inside a single 64-bit word, so the test costs one memory
+ *   read. About 16 filter bits are kept per name, which lets through
+ *   roughly one unknown name in a few hundred.
+ */
+#ifndef __NAME_INDEX__
+#define __NAME_INDEX__
+
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+class NameIndex {
+    public:
+        typedef uint32_t VertexId;
+
+        static const VertexId NO_VERTEX = UINT32_MAX;
+
+        explicit NameIndex(std::pmr::memory_resource *resource);
+
+        void build(const std::pmr::vector<std::string_view> &names);
+
+        VertexId find(std::string_view name) const;
+        bool     may_contain(std::string_view name) const;
+
+    private:
+        struct Slot {
+            uint32_t tag;
+            VertexId id;      /* NO_VERTEX when the slot is empty */
+        };
+
+        static uint64_t filter_bits(uint64_t hash);
+
+        const std::pmr::vector<std::string_view> *names;
+        std::pmr::vector<Slot>     slots;
+        std::pmr::vector<uint64_t> filter;
+        uint64_t slotMask;
+        uint64_t filterMask;
+};
+
+#endif /* __NAME_INDEX__ */
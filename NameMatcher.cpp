@@ -0,0 +1,330 @@
+/*
+ * NameMatcher.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Case- and accent-insensitive matching and trigram suggestions for
+ *   artist names.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "NameMatcher.h"
+#include "Parallel.h"
+
+using namespace std;
+
+namespace {
+
+/* postings read per suggestion before the common trigrams are left out */
+const size_t POSTING_BUDGET = 16384;
+
+/* candidates scored in full per suggestion asked for */
+const size_t SCORED_PER_MATCH = 16;
+
+/* base letters of U+00C0 .. U+00FF and U+0100 .. U+017F; '?' marks a
+ * letter that folds to two (see fold_name) or is left alone */
+const char LATIN_1[] = "aaaaaa?ceeeeiiiidnooooo?ouuuuy??"
+                       "aaaaaa?ceeeeiiiidnooooo?ouuuuy?y";
+const char EXTENDED_A[] = "aaaaaaccccccccddddeeeeeeeeeegggggggghhhh"
+                          "iiiiiiiiii??jjkkkllllllllllnnnnnnnnnoooooo"
+                          "??rrrrrrssssssssttttttuuuuuuuuuuuuwwyyyzzz"
+                          "zzzs";
+
+static_assert(sizeof(LATIN_1) == 0x40 + 1, "one letter per code point");
+static_assert(sizeof(EXTENDED_A) == 0x80 + 1, "one letter per code point");
+
+}
+
+/*
+ * @function: fold_name
+ * @purpose: Folds a name for matching that ignores case and accents.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: ASCII letters are lowercased; letters of U+00C0 ..
+ * U+017F lose their accents (and their case), with Æ, Œ, Ĳ and ß
+ * becoming "ae", "oe", "ij" and "ss"; combining accents (U+0300 ..
+ * U+036F) are dropped. Every other byte is copied as it is.
+ *
+ * @parameters: name - The name to fold (string_view).
+ *
+ * @returns: The folded name (string).
+ */
+
+string fold_name(string_view name)
+{
+    string folded;
+    folded.reserve(name.size());
+
+    for (size_t i = 0; i < name.size(); i++) {
+        unsigned char c = name[i];
+        if (c >= 'A' and c <= 'Z') {
+            folded += char(c - 'A' + 'a');
+            continue;
+        }
+        if ((c & 0xe0) != 0xc0 or i + 1 == name.size() or
+            (name[i + 1] & 0xc0) != 0x80) {
+            folded += char(c);
+            continue;
+        }
+
+        /* a two-byte UTF-8 sequence */
+        unsigned point = (c & 0x1f) << 6 | (name[i + 1] & 0x3f);
+        char letter = '?';
+        if (point >= 0xc0 and point <= 0xff) {
+            letter = LATIN_1[point - 0xc0];
+        } else if (point >= 0x100 and point <= 0x17f) {
+            letter = EXTENDED_A[point - 0x100];
+        } else if (point >= 0x300 and point <= 0x36f) {
+            i++;
+            continue;
+        }
+
+        if (letter != '?') {
+            folded += letter;
+        } else if (point == 0xc6 or point == 0xe6) {
+            folded += "ae";
+        } else if (point == 0x152 or point == 0x153) {
+            folded += "oe";
+        } else if (point == 0x132 or point == 0x133) {
+            folded += "ij";
+        } else if (point == 0xdf) {
+            folded += "ss";
+        } else {
+            folded.append(name.substr(i, 2));
+        }
+        i++;
+    }
+    return folded;
+}
+
+/*
+ * @constructor: NameMatcher
+ * @purpose: Folds every artist name of a graph and indexes its
+ * trigrams.
+ *
+ * @preconditions: None; the matcher keeps its own copies of the names.
+ *
+ * @postconditions: Artist ids are those of 'graph'. Folding and
+ * trigram extraction run on up to 'threads' threads, each sorting the
+ * postings of its own range of artists; the sorted runs are merged.
+ *
+ * @parameters: graph - The artists to match against
+ * (const CompactGraph&), threads - How many threads to use (size_t).
+ *
+ * @returns: None.
+ */
+
+NameMatcher::NameMatcher(const CompactGraph &graph, size_t threads)
+{
+    size_t n = graph.vertex_count();
+    threads = max<size_t>(1, min(threads, n / 1024));
+    folded.resize(n);
+
+    typedef pair<uint32_t, VertexId> Posting;
+    vector<vector<Posting>> runs(threads);
+
+    parallel_ranges(n, threads, [&](size_t begin, size_t end, size_t t) {
+        vector<uint32_t> grams;
+        for (size_t v = begin; v < end; v++) {
+            folded[v] = fold_name(graph.vertex_name(v));
+            trigrams(folded[v], grams);
+            for (uint32_t gram : grams) {
+                runs[t].emplace_back(gram, v);
+            }
+        }
+        sort(runs[t].begin(), runs[t].end());
+    });
+
+    vector<Posting> postings = move(runs[0]);
+    for (size_t t = 1; t < threads; t++) {
+        size_t middle = postings.size();
+        postings.insert(postings.end(), runs[t].begin(), runs[t].end());
+        inplace_merge(postings.begin(), postings.begin() + middle,
+                      postings.end());
+        vector<Posting>().swap(runs[t]);
+    }
+
+    ids.reserve(postings.size());
+    for (const Posting &posting : postings) {
+        if (gramKeys.empty() or gramKeys.back() != posting.first) {
+            gramKeys.push_back(posting.first);
+            gramOffsets.push_back(ids.size());
+        }
+        ids.push_back(posting.second);
+    }
+    gramOffsets.push_back(ids.size());
+
+    /* the first artist wins when several fold to the same name */
+    byFolded.reserve(n);
+    for (size_t v = 0; v < n; v++) {
+        byFolded.emplace(folded[v], v);
+    }
+}
+
+/*
+ * @function: find_folded
+ * @purpose: Looks up an artist whose name matches, ignoring case and
+ * accents.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: name - The name to look up (string_view).
+ *
+ * @returns: The id of the first artist whose folded name equals the
+ * folded 'name', or NO_VERTEX if there is none (VertexId).
+ */
+
+NameMatcher::VertexId NameMatcher::find_folded(string_view name) const
+{
+    auto found = byFolded.find(fold_name(name));
+    if (found == byFolded.end()) {
+        return CompactGraph::NO_VERTEX;
+    }
+    return found->second;
+}
+
+/*
+ * @function: suggest
+ * @purpose: Finds the artists whose names are most like a name.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: 'matches' holds at most 'count' ids, best first;
+ * artists sharing no trigram with 'name' are never suggested. Equal
+ * scores are broken by id, so the result does not depend on timing.
+ *
+ * @parameters: name - The name that was not found (string_view),
+ * count - How many suggestions to make (size_t), matches - Filled with
+ * the suggested artists (vector<VertexId>&).
+ *
+ * @returns: None.
+ */
+
+void NameMatcher::suggest(string_view name, size_t count,
+                          vector<VertexId> &matches) const
+{
+    matches.clear();
+    vector<uint32_t> grams;
+    trigrams(fold_name(name), grams);
+
+    /* (postings, index into gramKeys) of each trigram, rarest first */
+    vector<pair<size_t, size_t>> lists;
+    for (uint32_t gram : grams) {
+        auto key = lower_bound(gramKeys.begin(), gramKeys.end(), gram);
+        if (key != gramKeys.end() and *key == gram) {
+            size_t k = key - gramKeys.begin();
+            lists.emplace_back(gramOffsets[k + 1] - gramOffsets[k], k);
+        }
+    }
+    sort(lists.begin(), lists.end());
+
+    vector<VertexId> found;
+    for (const pair<size_t, size_t> &list : lists) {
+        if (not found.empty() and
+            found.size() + list.first > POSTING_BUDGET) {
+            break;
+        }
+        auto first = ids.begin() + gramOffsets[list.second];
+        found.insert(found.end(), first,
+                     first + min(list.first, POSTING_BUDGET));
+    }
+    sort(found.begin(), found.end());
+
+    /* (-trigrams shared, id), so the most shared sort first */
+    vector<pair<long, VertexId>> shared;
+    for (size_t i = 0; i < found.size(); ) {
+        size_t j = i;
+        while (j < found.size() and found[j] == found[i]) {
+            j++;
+        }
+        shared.emplace_back(-long(j - i), found[i]);
+        i = j;
+    }
+    size_t keep = min(shared.size(), max<size_t>(64, count * SCORED_PER_MATCH));
+    partial_sort(shared.begin(), shared.begin() + keep, shared.end());
+
+    vector<pair<double, VertexId>> scored;
+    for (size_t i = 0; i < keep; i++) {
+        scored.emplace_back(-similarity(grams, shared[i].second),
+                            shared[i].second);
+    }
+    sort(scored.begin(), scored.end());
+    for (size_t i = 0; i < scored.size() and i < count; i++) {
+        matches.push_back(scored[i].second);
+    }
+}
+
+/*
+ * @function: trigrams
+ * @purpose: Lists the distinct trigrams of a folded name.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: The name is padded with two spaces in front and one
+ * behind, so short names and word starts still have trigrams.
+ *
+ * @parameters: folded - A folded name (string_view), grams - Filled
+ * with its trigrams, sorted (vector<uint32_t>&).
+ *
+ * @returns: None.
+ */
+
+void NameMatcher::trigrams(string_view folded, vector<uint32_t> &grams)
+{
+    grams.clear();
+    uint32_t window = uint32_t(' ') << 8 | ' ';
+    for (size_t i = 0; i <= folded.size(); i++) {
+        unsigned char c = i < folded.size() ? folded[i] : ' ';
+        window = (window << 8 | c) & 0xffffff;
+        grams.push_back(window);
+    }
+    sort(grams.begin(), grams.end());
+    grams.erase(unique(grams.begin(), grams.end()), grams.end());
+}
+
+/*
+ * @function: similarity
+ * @purpose: Scores how alike a name and an artist's name are.
+ *
+ * @preconditions: 'grams' came from trigrams().
+ *
+ * @postconditions: None.
+ *
+ * @parameters: grams - The name's trigrams (const vector<uint32_t>&),
+ * candidate - An artist (VertexId).
+ *
+ * @returns: The Dice coefficient of the two trigram sets, from 0 (no
+ * trigram shared) to 1 (the same set) (double).
+ */
+
+double NameMatcher::similarity(const vector<uint32_t> &grams,
+                               VertexId candidate) const
+{
+    vector<uint32_t> other;
+    trigrams(folded[candidate], other);
+
+    size_t common = 0;
+    for (size_t i = 0, j = 0; i < grams.size() and j < other.size(); ) {
+        if (grams[i] < other[j]) {
+            i++;
+        } else if (other[j] < grams[i]) {
+            j++;
+        } else {
+            common++;
+            i++;
+            j++;
+        }
+    }
+    return 2.0 * common / (grams.size() + other.size());
+}
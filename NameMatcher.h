@@ -0,0 +1,68 @@
+/*
+ * NameMatcher.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Forgiving artist lookup, for names typed by people. Every name is
+ *   folded (fold_name): ASCII letters are lowercased and the accented
+ *   Latin letters of Latin-1 and Latin Extended-A lose their accents,
+ *   so "Beyoncé", "BEYONCE" and "beyonce" all fold to "beyonce".
+ *
+ *   find_folded matches a name against the folded names exactly.
+ *   suggest ranks artists by how many trigrams (three-byte windows of
+ *   the folded name, padded with spaces at both ends) they share with
+ *   a misspelled name, scored by the Dice coefficient, and returns the
+ *   best few. Candidates come from an inverted index from trigram to
+ *   artist ids, read rarest trigram first until a fixed budget of
+ *   postings is spent; trigrams shared by much of the dataset ("art",
+ *   "the") are then only used for scoring, so a lookup does a bounded
+ *   amount of work however large the graph.
+ *
+ *   The folded names and the trigram postings are computed in parallel
+ *   when the matcher is built.
+ */
+#ifndef __NAME_MATCHER__
+#define __NAME_MATCHER__
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "CompactGraph.h"
+
+std::string fold_name(std::string_view name);
+
+class NameMatcher {
+    public:
+        typedef CompactGraph::VertexId VertexId;
+
+        NameMatcher(const CompactGraph &graph, size_t threads);
+
+        /* byFolded holds views of 'folded' */
+        NameMatcher(const NameMatcher &) = delete;
+        NameMatcher &operator=(const NameMatcher &) = delete;
+
+        VertexId find_folded(std::string_view name) const;
+        void     suggest(std::string_view name, size_t count,
+                         std::vector<VertexId> &matches) const;
+
+    private:
+        static void trigrams(std::string_view folded,
+                             std::vector<uint32_t> &grams);
+        double similarity(const std::vector<uint32_t> &grams,
+                          VertexId candidate) const;
+
+        std::vector<std::string> folded;
+        std::unordered_map<std::string_view, VertexId> byFolded;
+
+        /* postings of gramKeys[i] are ids[gramOffsets[i] ..
+         * gramOffsets[i + 1]), ascending; gramKeys is sorted */
+        std::vector<uint32_t> gramKeys;
+        std::vector<size_t>   gramOffsets;
+        std::vector<VertexId> ids;
+};
+
+#endif /* __NAME_MATCHER__ */
@@ -0,0 +1,48 @@
+/*
+ * NoAllocStats.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   AllocStats.h for builds that keep the standard operator new: no
+ *   allocation is counted, so --alloc-stats is refused.
+ */
+#include <cstdint>
+
+#include "AllocStats.h"
+
+/*
+ * @function: allocation_count
+ * @purpose: Stands in for the count AllocStats.o keeps.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: Zero (uint64_t).
+ */
+
+uint64_t allocation_count()
+{
+    return 0;
+}
+
+/*
+ * @function: allocation_counting
+ * @purpose: Reports whether this build counts allocations.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: False (bool).
+ */
+
+bool allocation_counting()
+{
+    return false;
+}
@@ -0,0 +1,129 @@
+/*
+ * OrderedOutput.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   The reorder window that writes query results in command order.
+ */
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "OrderedOutput.h"
+
+using namespace std;
+
+/*
+ * @constructor: OrderedOutput
+ * @purpose: Constructs an empty window in front of a stream.
+ *
+ * @preconditions: 'sink' outlives the window.
+ *
+ * @postconditions: The first sequence number handed out is 0.
+ *
+ * @parameters: sink - Where results are written (ostream&),
+ * window - How many results may be outstanding at once (size_t),
+ * inOrder - Whether results are written in sequence order or as
+ * they are delivered (bool).
+ *
+ * @returns: None.
+ */
+
+OrderedOutput::OrderedOutput(ostream &sink, size_t window, bool inOrder)
+    : sink(sink), inOrder(inOrder), slots(max<size_t>(1, window)),
+      ready(max<size_t>(1, window), false),
+      nextReserved(0), nextWritten(0)
+{
+
+}
+
+/*
+ * @function: reserve
+ * @purpose: Takes the next sequence number for a query about to run.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: Blocks while the window is full, that is until the
+ * result 'window' places earlier has been written.
+ *
+ * @parameters: None.
+ *
+ * @returns: The query's sequence number (size_t).
+ */
+
+size_t OrderedOutput::reserve()
+{
+    unique_lock<mutex> guard(lock);
+    written.wait(guard, [&] {
+        return nextReserved - nextWritten < slots.size();
+    });
+    return nextReserved++;
+}
+
+/*
+ * @function: deliver
+ * @purpose: Hands in a finished query's result.
+ *
+ * @preconditions: 'sequence' came from reserve() and has not been
+ * delivered before.
+ *
+ * @postconditions: If every earlier result has been written, this one
+ * is written too, followed by any later ones already waiting, and the
+ * stream is flushed. Otherwise the result waits in its slot. Out of
+ * order, the result is written and flushed at once.
+ *
+ * @parameters: sequence - The query's number (size_t), text - Its
+ * complete output (string&&).
+ *
+ * @returns: None.
+ */
+
+void OrderedOutput::deliver(size_t sequence, string &&text)
+{
+    lock_guard<mutex> guard(lock);
+    if (not inOrder) {
+        sink << text << flush;
+        nextWritten++;
+        written.notify_all();
+        return;
+    }
+
+    size_t slot = sequence % slots.size();
+    slots[slot] = move(text);
+    ready[slot] = true;
+
+    if (sequence != nextWritten) {
+        return;
+    }
+    while (ready[slot]) {
+        sink << slots[slot];
+        slots[slot].clear();
+        ready[slot] = false;
+        nextWritten++;
+        slot = nextWritten % slots.size();
+    }
+    sink.flush();
+    written.notify_all();
+}
+
+/*
+ * @function: drain
+ * @purpose: Waits until every reserved result has been written.
+ *
+ * @preconditions: Every reserved sequence number will be delivered.
+ *
+ * @postconditions: Nothing is outstanding.
+ *
+ * @parameters: None.
+ *
+ * @returns: None.
+ */
+
+void OrderedOutput::drain()
+{
+    unique_lock<mutex> guard(lock);
+    written.wait(guard, [&] { return nextWritten == nextReserved; });
+}
@@ -0,0 +1,57 @@
+/*
+ * OrderedOutput.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Collects the results of queries that may finish in any order and
+ *   writes them in the order the queries were given. Each query takes a
+ *   sequence number before it starts, formats its whole result into its
+ *   own buffer, and hands the buffer back under that number; buffers
+ *   are written to the output stream as soon as every earlier one has
+ *   been. The output is therefore byte for byte what running the
+ *   queries one after another would print, however many run at once.
+ *
+ *   At most 'window' results may be outstanding (taken but not yet
+ *   written), which bounds the memory held by finished results waiting
+ *   on a slow one; reserve() blocks until the oldest is written.
+ *
+ *   A window made with inOrder false writes each result as soon as it
+ *   is delivered instead, so a quick query never waits on a slow one
+ *   that was given before it (the --async mode of interactive use).
+ */
+#ifndef __ORDERED_OUTPUT__
+#define __ORDERED_OUTPUT__
+
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class OrderedOutput {
+    public:
+        OrderedOutput(std::ostream &sink, size_t window,
+                      bool inOrder = true);
+
+        OrderedOutput(const OrderedOutput &) = delete;
+        OrderedOutput &operator=(const OrderedOutput &) = delete;
+
+        size_t reserve();
+        void   deliver(size_t sequence, std::string &&text);
+        void   drain();
+
+    private:
+        std::ostream &sink;
+        std::mutex lock;
+        std::condition_variable written;
+        bool inOrder;
+
+        /* result i waits in slots[i % window] until it is written */
+        std::vector<std::string> slots;
+        std::vector<bool>        ready;
+        size_t nextReserved;
+        size_t nextWritten;     /* out of order: how many were written */
+};
+
+#endif /* __ORDERED_OUTPUT__ */
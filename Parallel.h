@@ -0,0 +1,63 @@
+/*
+ * Parallel.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   A minimal fork-join helper. parallel_ranges splits [0, count) into
+ *   one contiguous range per thread, runs the body on each range on its
+ *   own std::thread and waits for all of them. Work that writes shared
+ *   arrays partitions them by these ranges, so no locks are needed.
+ */
+#ifndef __PARALLEL__
+#define __PARALLEL__
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/* the number of threads to use when none was asked for */
+inline size_t default_threads()
+{
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+/*
+ * @function: parallel_ranges
+ * @purpose: Runs body(begin, end, thread) for 'threads' contiguous
+ * ranges that together cover [0, count).
+ *
+ * @preconditions: 'threads' is at least 1.
+ *
+ * @postconditions: Every range has been processed when this returns.
+ * Range t comes before range t + 1, and a single thread runs on the
+ * calling thread without spawning anything.
+ *
+ * @parameters: count - The number of items (size_t), threads - The
+ * number of ranges (size_t), body - Called once per range (Body).
+ *
+ * @returns: None.
+ */
+
+template <typename Body>
+void parallel_ranges(size_t count, size_t threads, Body body)
+{
+    if (threads <= 1) {
+        body(size_t(0), count, size_t(0));
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (size_t t = 0; t < threads; t++) {
+        size_t begin = count * t / threads;
+        size_t end   = count * (t + 1) / threads;
+        workers.emplace_back(body, begin, end, t);
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+#endif /* __PARALLEL__ */
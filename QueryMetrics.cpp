@@ -0,0 +1,245 @@
+/*
+ * QueryMetrics.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   JSON lines and histograms for --metrics.
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string_view>
+
+#include "QueryMetrics.h"
+
+using namespace std;
+
+/*
+ * @function: writeJsonString
+ * @purpose: Writes text as a quoted JSON string.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: Quotes, backslashes and control characters are
+ * escaped; other bytes (including UTF-8) are copied as they are.
+ *
+ * @parameters: out - Where to write (ostream&), text - The text
+ * (string_view).
+ *
+ * @returns: None.
+ */
+
+static void writeJsonString(ostream &out, string_view text)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    out << '"';
+    for (char c : text) {
+        unsigned char byte = c;
+        if (c == '"' or c == '\\') {
+            out << '\\' << c;
+        } else if (byte < 0x20) {
+            out << "\\u00" << hex[byte >> 4] << hex[byte & 15];
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+/*
+ * @constructor: Histogram
+ * @purpose: Constructs an empty histogram.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: No values have been added.
+ *
+ * @parameters: None.
+ *
+ * @returns: None.
+ */
+
+Histogram::Histogram()
+    : count(0), sum(0), lowest(0), highest(0)
+{
+    fill(buckets, buckets + BUCKETS, 0);
+}
+
+/*
+ * @function: add
+ * @purpose: Counts one value.
+ *
+ * @preconditions: 'value' is not negative.
+ *
+ * @postconditions: The value is in the bucket [2^(i-1), 2^i), or in
+ * bucket 0 if it is below 1.
+ *
+ * @parameters: value - The value to count (double).
+ *
+ * @returns: None.
+ */
+
+void Histogram::add(double value)
+{
+    int bucket = 0;
+    if (value >= 1) {
+        bucket = min(BUCKETS - 1, ilogb(value) + 1);
+    }
+    buckets[bucket]++;
+
+    if (count == 0 or value < lowest) {
+        lowest = value;
+    }
+    if (count == 0 or value > highest) {
+        highest = value;
+    }
+    sum += value;
+    count++;
+}
+
+/*
+ * @function: write_json
+ * @purpose: Writes the histogram as one JSON line.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: The line gives the count, min, max and mean, the
+ * upper bound of the buckets holding the median and 99th percentile
+ * (all 0 when nothing was recorded), and every non-empty bucket as {"lt": upper bound, "count": n}.
+ *
+ * @parameters: out - Where to write (ostream&), name - The metric's
+ * name (const char*).
+ *
+ * @returns: None.
+ */
+
+void Histogram::write_json(ostream &out, const char *name) const
+{
+    out << "{\"histogram\":";
+    writeJsonString(out, name);
+    out << ",\"count\":" << count
+        << ",\"min\":" << lowest
+        << ",\"max\":" << highest
+        << ",\"mean\":" << (count == 0 ? 0 : sum / count);
+
+    const char *labels[] = { "p50", "p99" };
+    const double ranks[] = { 0.50, 0.99 };
+    for (int p = 0; p < 2; p++) {
+        if (count == 0) {
+            out << ",\"" << labels[p] << "\":0";
+            continue;
+        }
+        uint64_t seen = 0;
+        int bucket = 0;
+        while (bucket < BUCKETS - 1 and
+               seen + buckets[bucket] < ceil(ranks[p] * count)) {
+            seen += buckets[bucket];
+            bucket++;
+        }
+        out << ",\"" << labels[p] << "\":" << ldexp(1.0, bucket);
+    }
+
+    out << ",\"buckets\":[";
+    bool first = true;
+    for (int bucket = 0; bucket < BUCKETS; bucket++) {
+        if (buckets[bucket] == 0) {
+            continue;
+        }
+        out << (first ? "" : ",") << "{\"lt\":" << ldexp(1.0, bucket)
+            << ",\"count\":" << buckets[bucket] << "}";
+        first = false;
+    }
+    out << "]}\n";
+}
+
+/*
+ * @constructor: QueryMetrics
+ * @purpose: Constructs a recorder that writes to the given stream.
+ *
+ * @preconditions: 'out' outlives the recorder.
+ *
+ * @postconditions: No queries have been recorded.
+ *
+ * @parameters: out - Where the JSON lines go (ostream&).
+ *
+ * @returns: None.
+ */
+
+QueryMetrics::QueryMetrics(ostream &out)
+    : out(out), queries(0), budgetHits(0)
+{
+
+}
+
+/*
+ * @function: record
+ * @purpose: Writes one query's measurements as a JSON line and adds
+ * them to the histograms.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None. Queries finishing on different threads may
+ * record at the same time; their lines are never interleaved.
+ *
+ * @parameters: query - The measurements (const QueryRecord&).
+ *
+ * @returns: None.
+ */
+
+void QueryMetrics::record(const QueryRecord &query)
+{
+    lock_guard<mutex> guard(lock);
+    out << "{\"query\":";
+    writeJsonString(out, query.command);
+    out << ",\"from\":";
+    writeJsonString(out, query.from);
+    out << ",\"to\":";
+    writeJsonString(out, query.to);
+    out << ",\"found\":" << (query.found ? "true" : "false")
+        << ",\"visited\":" << query.visited
+        << ",\"edges_scanned\":" << query.edgesScanned
+        << ",\"frontier_peak\":" << query.frontierPeak
+        << ",\"path_length\":" << query.pathLength
+        << ",\"budget_hit\":" << (query.budgetHit ? "true" : "false")
+        << ",\"search_us\":" << query.searchMicros
+        << ",\"print_us\":" << query.printMicros << "}\n";
+
+    visited.add(query.visited);
+    edgesScanned.add(query.edgesScanned);
+    frontierPeak.add(query.frontierPeak);
+    pathLength.add(query.pathLength);
+    searchMicros.add(query.searchMicros);
+    printMicros.add(query.printMicros);
+    queries++;
+    budgetHits += query.budgetHit;
+}
+
+/*
+ * @function: report
+ * @purpose: Writes every histogram, one JSON line each.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: The stream is flushed.
+ *
+ * @parameters: None.
+ *
+ * @returns: None.
+ */
+
+void QueryMetrics::report() const
+{
+    visited.write_json(out, "visited");
+    edgesScanned.write_json(out, "edges_scanned");
+    frontierPeak.write_json(out, "frontier_peak");
+    pathLength.write_json(out, "path_length");
+    searchMicros.write_json(out, "search_us");
+    printMicros.write_json(out, "print_us");
+    out << "{\"queries\":" << queries
+        << ",\"budget_hits\":" << budgetHits << "}\n";
+    out.flush();
+}
@@ -0,0 +1,74 @@
+/*
+ * QueryMetrics.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Per-query instrumentation for --metrics. Each bfs, dfs and not
+ *   query reports how much of the graph it touched and how long it
+ *   spent searching and printing; every report is written as one JSON
+ *   line and folded into power-of-two histograms that are written, also
+ *   as JSON lines, when the program finishes, with a count of the
+ *   queries whose SearchBudget ran out. SixDegrees only reads the
+ *   clock when a recorder is configured, so queries run without
+ *   --metrics pay nothing but a null check.
+ */
+#ifndef __QUERY_METRICS__
+#define __QUERY_METRICS__
+
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string_view>
+
+struct QueryRecord {
+    const char      *command = "";
+    std::string_view from;
+    std::string_view to;
+    bool   found        = false;
+    size_t visited      = 0;     /* artists the search marked */
+    size_t edgesScanned = 0;     /* adjacency entries examined */
+    size_t frontierPeak = 0;     /* largest BFS queue / DFS stack */
+    size_t pathLength   = 0;     /* collaborations printed */
+    bool   budgetHit    = false; /* stopped by its SearchBudget */
+    double searchMicros = 0;
+    double printMicros  = 0;
+};
+
+/* counts of values in [0, 1), [1, 2), [2, 4), [4, 8), ... */
+class Histogram {
+    public:
+        Histogram();
+
+        void add(double value);
+        void write_json(std::ostream &out, const char *name) const;
+
+    private:
+        static const int BUCKETS = 64;
+
+        uint64_t buckets[BUCKETS];
+        uint64_t count;
+        double   sum, lowest, highest;
+};
+
+class QueryMetrics {
+    public:
+        explicit QueryMetrics(std::ostream &out);
+
+        void record(const QueryRecord &query);
+        void report() const;
+
+    private:
+        std::ostream &out;
+        std::mutex   lock;          /* queries may finish concurrently */
+        Histogram visited;
+        Histogram edgesScanned;
+        Histogram frontierPeak;
+        Histogram pathLength;
+        Histogram searchMicros;
+        Histogram printMicros;
+        uint64_t  queries;
+        uint64_t  budgetHits;
+};
+
+#endif /* __QUERY_METRICS__ */
@@ -0,0 +1,306 @@
+/*
+ * QueryRunner.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Sequential and parallel execution of queries with ordered output.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "AllocStats.h"
+#include "QueryRunner.h"
+
+using namespace std;
+
+/*
+ * @constructor: QueryRunner
+ * @purpose: Constructs a runner, starting its workers if it has more
+ * than one job.
+ *
+ * @preconditions: The graph of 'sixDegrees' is populated and its
+ * output stream configured; both outlive the runner.
+ *
+ * @postconditions: 'jobs' threads wait for queries, or none if 'jobs'
+ * is 0 or 1.
+ *
+ * @parameters: sixDegrees - Runs the queries (SixDegrees&), jobs - How
+ * many queries may run at once (size_t), allocStats - Whether to
+ * report each query's heap allocations (bool), inOrder - Whether
+ * results are written in the order given or as they finish (bool).
+ *
+ * @returns: None.
+ */
+
+QueryRunner::QueryRunner(SixDegrees &sixDegrees, size_t jobs,
+                         bool allocStats, bool inOrder)
+    : sixDegrees(sixDegrees), allocStats(allocStats),
+      ordered(*sixDegrees.output, jobs * WINDOW_PER_JOB, inOrder),
+      running(0), barrierRunning(false), closed(false)
+{
+    for (size_t i = 0; jobs > 1 and i < jobs; i++) {
+        workers.emplace_back(&QueryRunner::work, this);
+    }
+}
+
+/*
+ * @destructor: ~QueryRunner
+ * @purpose: Finishes any queries still running.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: See finish().
+ *
+ * @parameters: None.
+ *
+ * @returns: None.
+ */
+
+QueryRunner::~QueryRunner()
+{
+    finish();
+}
+
+/*
+ * @function: submit
+ * @purpose: Runs a query, or queues it for a worker.
+ *
+ * @preconditions: finish() has not been called.
+ *
+ * @postconditions: Without workers the query has run and printed its
+ * result. With workers it has a place in the output and will be run;
+ * this blocks while the reorder window is full.
+ *
+ * @parameters: query - The query (Query&&).
+ *
+ * @returns: None.
+ */
+
+void QueryRunner::submit(Query &&query)
+{
+    if (workers.empty()) {
+        StopToken stop;
+        run(query, *sixDegrees.output, stop);
+        return;
+    }
+
+    Job job { ordered.reserve(), move(query), make_unique<StopToken>() };
+    {
+        lock_guard<mutex> guard(lock);
+        inFlight.push_back(job.stop.get());
+        queue.push_back(move(job));
+    }
+    queued.notify_one();
+}
+
+/*
+ * @function: cancel
+ * @purpose: Stops every query submitted so far that has not finished.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: Queued queries print the cancellation message
+ * instead of running; running ones stop at their next check and
+ * print it in place of their result. Without workers every query has
+ * already finished, so nothing happens.
+ *
+ * @parameters: None.
+ *
+ * @returns: None.
+ */
+
+void QueryRunner::cancel()
+{
+    lock_guard<mutex> guard(lock);
+    for (StopToken *stop : inFlight) {
+        stop->cancel();
+    }
+}
+
+/*
+ * @function: finish
+ * @purpose: Waits for every submitted query and stops the workers.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: Every result has been written, in submission
+ * order, and no worker is left running.
+ *
+ * @parameters: None.
+ *
+ * @returns: None.
+ */
+
+void QueryRunner::finish()
+{
+    {
+        lock_guard<mutex> guard(lock);
+        closed = true;
+    }
+    queued.notify_all();
+    for (thread &worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    ordered.drain();
+}
+
+/*
+ * @function: startable
+ * @purpose: Says whether a worker may take the query at the front of
+ * the queue.
+ *
+ * @preconditions: 'lock' is held.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: True iff the queue is not empty, no reload is running
+ * and, if the front query is a reload, no other query is running
+ * (bool).
+ */
+
+bool QueryRunner::startable() const
+{
+    if (queue.empty() or barrierRunning) {
+        return false;
+    }
+    return queue.front().query.command != "reload" or running == 0;
+}
+
+/*
+ * @function: work
+ * @purpose: A worker's loop: runs queued queries into their own
+ * buffers and hands the buffers to the reorder window.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: Returns once the runner is finished and the queue
+ * is empty. A reload runs alone: it waits for the queries taken
+ * before it, and the queries after it wait for it.
+ *
+ * @parameters: None.
+ *
+ * @returns: None.
+ */
+
+void QueryRunner::work()
+{
+    ostringstream buffer;
+    while (true) {
+        Job next;
+        bool barrier;
+        {
+            unique_lock<mutex> guard(lock);
+            queued.wait(guard, [&] {
+                return (closed and queue.empty()) or startable();
+            });
+            if (queue.empty()) {
+                return;
+            }
+            next = move(queue.front());
+            queue.pop_front();
+            barrier = next.query.command == "reload";
+            barrierRunning = barrier;
+            running++;
+        }
+
+        buffer.str("");
+        run(next.query, buffer, *next.stop);
+        /* before the barrier lifts, so even --async prints a reload
+         * ahead of the queries after it */
+        ordered.deliver(next.sequence, buffer.str());
+        bool idle;
+        {
+            lock_guard<mutex> guard(lock);
+            inFlight.erase(find(inFlight.begin(), inFlight.end(),
+                                next.stop.get()));
+            running--;
+            barrierRunning = false;
+            idle = running == 0;
+        }
+        /* a reload waiting for the others, or the queries held behind
+         * one, may start now */
+        if (barrier or idle) {
+            queued.notify_all();
+        }
+    }
+}
+
+/*
+ * @function: run
+ * @purpose: Runs one query.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: The query's complete result is in 'out', or the
+ * cancellation message if it was cancelled before it started. With
+ * --alloc-stats, its allocation count is printed to cerr.
+ *
+ * @parameters: query - The query (const Query&), out - Where its
+ * result goes (ostream&), stop - The query's token (StopToken&).
+ *
+ * @returns: None.
+ */
+
+void QueryRunner::run(const Query &query, ostream &out, StopToken &stop)
+{
+    if (query.command.empty()) {
+        out << query.message << flush;
+        return;
+    }
+    if (stop.cancelled()) {
+        out << StopToken::MESSAGE << flush;
+        return;
+    }
+
+    if (sixDegrees.sharded() and query.command != "bfs" and
+        query.command != "not") {
+        out << query.command << " is not available with --shards." << endl;
+        return;
+    }
+
+    uint64_t before = allocation_count();
+    if (query.command == "bfs") {
+        sixDegrees.bfs_function(query.from, query.to, out, &stop);
+    } else if (query.command == "dfs") {
+        sixDegrees.dfs_function(query.from, query.to, out, &stop);
+    } else if (query.command == "not") {
+        sixDegrees.not_function(query.from, query.to, query.avoid, out,
+                                &stop);
+    } else if (query.command == "through") {
+        sixDegrees.through_function(query.from, query.to, query.songs, out,
+                                    &stop);
+    } else if (query.command == "avoid") {
+        sixDegrees.avoid_function(query.from, query.to, query.songs, out,
+                                  &stop);
+    } else if (query.command == "mbfs") {
+        sixDegrees.mbfs_function(query.sources, query.targets, out, &stop);
+    } else if (query.command == "matrix") {
+        sixDegrees.matrix_function(query.listFile, query.matrixFile, out,
+                                   &stop);
+    } else if (query.command == "export") {
+        sixDegrees.export_function(query.dataFile, out, &stop);
+    } else if (query.command == "dump") {
+        sixDegrees.dump_function(query.dataFile, out);
+    } else if (query.command == "reload") {
+        sixDegrees.reload_function(query.dataFile, out, &stop);
+    } else if (query.command == "within") {
+        sixDegrees.within_function(query.from, query.degrees, out, &stop);
+    }
+
+    if (allocStats) {
+        uint64_t count = allocation_count() - before;
+        lock_guard<mutex> guard(lock);
+        cerr << query.command << ": " << count << " allocations" << endl;
+    }
+}
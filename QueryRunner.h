@@ -0,0 +1,104 @@
+/*
+ * QueryRunner.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Runs the queries read from the command stream. With one job (the
+ *   default) each query runs as soon as it is submitted and prints
+ *   straight to the SixDegrees output stream, exactly as before. With
+ *   --jobs=N, N worker threads take queries off a queue, each query
+ *   formats its result into a buffer of its own, and an OrderedOutput
+ *   window writes the buffers in the order the queries were submitted,
+ *   so the output is the same for every N.
+ *
+ *   Messages that are not search results ("... is not a command") go
+ *   through the same window, so they keep their place in the output.
+ *
+ *   A reload is a barrier: it starts once every query given before it
+ *   has finished, and no query given after it starts until the new
+ *   graph is published, so each query searches the graph the commands
+ *   before it left, whatever the number of jobs.
+ *
+ *   For interactive use, --async writes each result as soon as its
+ *   query finishes, so quick queries are not held behind slow ones
+ *   given before them; reading the next command never waits for a
+ *   query either. Every query carries a StopToken, and cancel() stops
+ *   all that are queued or running.
+ */
+#ifndef __QUERY_RUNNER__
+#define __QUERY_RUNNER__
+
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Artist.h"
+#include "OrderedOutput.h"
+#include "SixDegrees.h"
+
+/* one complete command; an empty 'command' just prints 'message' */
+struct Query {
+    std::string command;
+    Artist from;
+    Artist to;
+    std::vector<Artist> avoid;
+    std::vector<Artist> sources;
+    std::vector<Artist> targets;
+    std::vector<std::string> songs;
+    std::string listFile;        /* matrix */
+    std::string matrixFile;
+    std::string dataFile;        /* reload, export, dump */
+    size_t degrees = 0;
+    std::string message;
+};
+
+class QueryRunner {
+    public:
+        QueryRunner(SixDegrees &sixDegrees, size_t jobs, bool allocStats,
+                    bool inOrder = true);
+        ~QueryRunner();
+
+        QueryRunner(const QueryRunner &) = delete;
+        QueryRunner &operator=(const QueryRunner &) = delete;
+
+        void submit(Query &&query);
+        void cancel();
+        void finish();
+
+    private:
+        /* results allowed to wait behind a slow query, per worker */
+        static const size_t WINDOW_PER_JOB = 64;
+
+        /* a queued query, its place in the output and its token */
+        struct Job {
+            size_t sequence;
+            Query query;
+            std::unique_ptr<StopToken> stop;
+        };
+
+        void run(const Query &query, std::ostream &out, StopToken &stop);
+        void work();
+        bool startable() const;
+
+        SixDegrees &sixDegrees;
+        bool allocStats;
+        OrderedOutput ordered;
+
+        std::mutex lock;
+        std::condition_variable queued;
+        std::deque<Job> queue;
+        std::vector<StopToken *> inFlight;    /* queued or running */
+        std::vector<std::thread> workers;
+        size_t running;                       /* taken off the queue */
+        bool barrierRunning;                  /* a reload is running */
+        bool closed;
+};
+
+#endif /* __QUERY_RUNNER__ */
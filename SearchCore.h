@@ -0,0 +1,277 @@
+/*
+ * SearchCore.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   The one traversal loop the path queries share, written once as a
+ *   template over three policies so the compiler builds a loop for each
+ *   combination with no runtime switch inside it:
+ *
+ *     Frontier  BreadthFirst, a queue (bfs, not, through, avoid and
+ *               mbfs), or DepthFirst, a stack (dfs)
+ *     Expand    which neighbors of an artist may be entered: AllEdges,
+ *               SongEdges (only artists sharing an allowed song) or
+ *               CreditedEdges (a bipartite graph, through its songs)
+ *     Exit      which artist ends the search: StopAt one target or
+ *               StopAtAny of a sorted list
+ *
+ *   Every artist entered records its predecessor and depth in the
+ *   workspace, since every query built on this prints a path. Artists
+ *   a query excludes are marked visited before the search starts, so
+ *   the loop never tests for them. traverse() picks the Expand policy
+ *   the graph's layout needs once per query.
+ */
+#ifndef __SEARCH_CORE__
+#define __SEARCH_CORE__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "CompactGraph.h"
+#include "FrontierKernel.h"
+#include "Traversal.h"
+
+/* Expand policies: append the unvisited neighbors of 'v' the search may
+ * enter to ws.frontier, in adjacency order, and return how many */
+struct AllEdges {
+    size_t operator()(const CompactGraph &graph, CompactGraph::VertexId v,
+                      TraversalWorkspace &ws) const
+    {
+        return append_unvisited(graph, v, ws);
+    }
+};
+
+/* the songs a song-filtered search may follow */
+struct SongFilter {
+    const SongCredits *credits;
+    const uint32_t    *allowed;   /* bitmap over the credits' song ids */
+    uint32_t          *marked;    /* clear bitmap over vertices */
+};
+
+struct SongEdges {
+    SongFilter songs;
+
+    size_t operator()(const CompactGraph &graph, CompactGraph::VertexId v,
+                      TraversalWorkspace &ws) const
+    {
+        return append_allowed(graph, v, ws, *songs.credits, songs.allowed,
+                              songs.marked);
+    }
+};
+
+struct CreditedEdges {
+    uint32_t *expanded;           /* songs already expanded, or nullptr */
+
+    size_t operator()(const CompactGraph &graph, CompactGraph::VertexId v,
+                      TraversalWorkspace &ws) const
+    {
+        return append_credited(graph, v, ws, expanded);
+    }
+};
+
+/* Exit policies: whether entering 'v' ends the search */
+struct StopAt {
+    CompactGraph::VertexId to;
+
+    bool operator()(CompactGraph::VertexId v) const { return v == to; }
+};
+
+struct StopAtAny {
+    const std::pmr::vector<CompactGraph::VertexId> *targets;    /* sorted */
+
+    bool operator()(CompactGraph::VertexId v) const
+    {
+        return std::binary_search(targets->begin(), targets->end(), v);
+    }
+};
+
+/*
+ * @function: BreadthFirst::search
+ * @purpose: Breadth-first search from several artists at once.
+ *
+ * @preconditions: 'ws' was reset for 'graph' and holds nothing on its
+ * frontier.
+ *
+ * @postconditions: The sources not yet visited are visited at depth 0,
+ * in order, and every artist reached has its predecessor and depth set
+ * in 'ws'. The search ends at the first artist 'exit' accepts, which
+ * is never a source, or once ws.interrupted() or ws.too_deep() says
+ * so.
+ *
+ * @parameters: graph - The graph (const CompactGraph&), ws - The
+ * search state (TraversalWorkspace&), first, last - The sources
+ * (const VertexId*), expand - The Expand policy, exit - The Exit
+ * policy.
+ *
+ * @returns: The artist the search ended at, or NO_VERTEX if it found
+ * none (VertexId).
+ */
+
+struct BreadthFirst {
+    typedef CompactGraph::VertexId VertexId;
+
+    /* a bipartite graph's songs are each expanded once */
+    static const bool SONGS_ONCE = true;
+
+    template <typename Expand, typename Exit>
+    static VertexId search(const CompactGraph &graph, TraversalWorkspace &ws,
+                           const VertexId *first, const VertexId *last,
+                           Expand expand, Exit exit)
+    {
+        for (const VertexId *source = first; source != last; source++) {
+            if (not ws.is_visited(*source)) {
+                ws.visit(*source, CompactGraph::NO_VERTEX, 0);
+                ws.frontier.push_back(*source);
+            }
+        }
+
+        for (size_t head = 0; head < ws.frontier.size(); head++) {
+            VertexId cur = ws.frontier[head];
+            if (ws.interrupted() or ws.too_deep(ws.depth(cur))) {
+                break;
+            }
+            size_t tail = ws.frontier.size();
+            ws.note_frontier(tail - head);
+            size_t found = expand(graph, cur, ws);
+            uint32_t depth = ws.depth(cur) + 1;
+
+            for (size_t i = tail; i < tail + found; i++) {
+                VertexId n = ws.frontier[i];
+                ws.visit(n, cur, depth);
+                if (exit(n)) {
+                    return n;
+                }
+            }
+        }
+        return CompactGraph::NO_VERTEX;
+    }
+};
+
+/*
+ * @function: DepthFirst::search
+ * @purpose: Depth-first search, from each source in turn.
+ *
+ * @preconditions: As BreadthFirst::search.
+ *
+ * @postconditions: Every artist entered has its predecessor and depth
+ * set in 'ws'. An artist is entered from the artist on top of the
+ * stack, trying its neighbors in adjacency order; the search ends at
+ * the first artist 'exit' accepts, even past the depth budget, or
+ * once ws.interrupted() says so.
+ *
+ * @parameters: As BreadthFirst::search.
+ *
+ * @returns: As BreadthFirst::search.
+ */
+
+struct DepthFirst {
+    typedef CompactGraph::VertexId VertexId;
+
+    /* a song may be reached again deeper down, so expand it again */
+    static const bool SONGS_ONCE = false;
+
+    template <typename Expand, typename Exit>
+    static VertexId search(const CompactGraph &graph, TraversalWorkspace &ws,
+                           const VertexId *first, const VertexId *last,
+                           Expand expand, Exit exit)
+    {
+        /* the neighbors of every artist on the stack, innermost last;
+         * a frame walks its own slice [next, end) of 'pending' */
+        struct Frame {
+            VertexId vertex;
+            size_t   begin, next, end;
+        };
+        std::pmr::vector<Frame> frames(&ws.arena);
+        std::vector<VertexId> &pending = ws.frontier;
+
+        auto enter = [&](VertexId v, VertexId pred, uint32_t depth) {
+            ws.visit(v, pred, depth);
+            size_t begin = pending.size();
+            expand(graph, v, ws);
+            frames.push_back(Frame { v, begin, begin, pending.size() });
+            ws.note_frontier(frames.size());
+        };
+
+        for (const VertexId *source = first; source != last; source++) {
+            if (ws.is_visited(*source)) {
+                continue;
+            }
+            enter(*source, CompactGraph::NO_VERTEX, 0);
+
+            while (not frames.empty() and not ws.interrupted()) {
+                Frame &top = frames.back();
+                while (top.next < top.end and
+                       ws.is_visited(pending[top.next])) {
+                    top.next++;
+                }
+                if (top.next == top.end) {
+                    pending.resize(top.begin);
+                    frames.pop_back();
+                    continue;
+                }
+
+                VertexId n = pending[top.next++];
+                if (exit(n)) {
+                    ws.visit(n, top.vertex, frames.size());
+                    return n;
+                }
+                if (not ws.too_deep(frames.size())) {
+                    enter(n, top.vertex, frames.size());
+                }
+            }
+            if (not frames.empty()) {
+                break;                  /* interrupted */
+            }
+        }
+        return CompactGraph::NO_VERTEX;
+    }
+};
+
+/*
+ * @function: traverse
+ * @purpose: Runs Frontier::search with the Expand policy that fits the
+ * graph and the query.
+ *
+ * @preconditions: As BreadthFirst::search.
+ *
+ * @postconditions: As Frontier::search. Only collaborations on songs
+ * 'songs' allows are followed if it is given; otherwise a bipartite
+ * graph is searched through its songs.
+ *
+ * @parameters: graph, ws, first, last - As BreadthFirst::search,
+ * songs - The allowed songs, or nullptr to follow every collaboration
+ * (const SongFilter*), exit - The Exit policy.
+ *
+ * @returns: As BreadthFirst::search.
+ */
+
+template <typename Frontier, typename Exit>
+CompactGraph::VertexId traverse(const CompactGraph &graph,
+                                TraversalWorkspace &ws,
+                                const CompactGraph::VertexId *first,
+                                const CompactGraph::VertexId *last,
+                                const SongFilter *songs, Exit exit)
+{
+    if (songs != nullptr) {
+        return Frontier::search(graph, ws, first, last, SongEdges { *songs },
+                                exit);
+    }
+    if (not graph.is_bipartite()) {
+        return Frontier::search(graph, ws, first, last, AllEdges(), exit);
+    }
+
+    /* in the workspace arena, so warmed-up queries do not allocate */
+    std::pmr::vector<uint32_t> expanded(&ws.arena);
+    if (Frontier::SONGS_ONCE) {
+        expanded.assign((graph.song_count() + 31) / 32, 0);
+    }
+    uint32_t *once = expanded.empty() ? nullptr : expanded.data();
+    return Frontier::search(graph, ws, first, last, CreditedEdges { once },
+                            exit);
+}
+
+#endif /* __SEARCH_CORE__ */
@@ -0,0 +1,727 @@
+/*
+ * ShardedSearch.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   The shard files, the worker processes that serve them, and the
+ *   coordinator that runs level-synchronous breadth-first searches
+ *   across the workers.
+ */
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ShardedSearch.h"
+
+using namespace std;
+
+typedef ShardCoordinator::VertexId VertexId;
+typedef ShardCoordinator::SongId   SongId;
+
+namespace {
+
+const char NAMES_MAGIC[4] = { 'S', 'D', 'S', 'N' };
+const char SHARD_MAGIC[4] = { 'S', 'D', 'S', 'H' };
+
+/* requests from the coordinator; every reply is a word count and
+ * that many words */
+enum Request : uint32_t {
+    RESET  = 1,    /* [v]: start a search with each v already visited */
+    EXPAND = 2,    /* [v, rank]: the edges out of frontier artists */
+    CLAIM  = 3,    /* [n, parent, song, rank, index]: keep the best */
+    PARENT = 4,    /* [v]: v's predecessor and the song joining them */
+};
+
+/* an edge found by EXPAND: n is reached from 'parent', the artist
+ * ranked 'rank' in the frontier, through its index'th neighbor */
+const size_t EDGE_WORDS = 5;
+
+/* little-endian fields of the shard files */
+void put32(ostream &out, uint32_t x)
+{
+    char bytes[4] = { char(x), char(x >> 8), char(x >> 16), char(x >> 24) };
+    out.write(bytes, sizeof bytes);
+}
+
+void put64(ostream &out, uint64_t x)
+{
+    put32(out, uint32_t(x));
+    put32(out, uint32_t(x >> 32));
+}
+
+bool get32(istream &in, uint32_t &x)
+{
+    unsigned char bytes[4];
+    if (not in.read(reinterpret_cast<char *>(bytes), sizeof bytes)) {
+        return false;
+    }
+    x = bytes[0] | bytes[1] << 8 | bytes[2] << 16 | uint32_t(bytes[3]) << 24;
+    return true;
+}
+
+bool get64(istream &in, uint64_t &x)
+{
+    uint32_t low, high;
+    if (not get32(in, low) or not get32(in, high)) {
+        return false;
+    }
+    x = low | uint64_t(high) << 32;
+    return true;
+}
+
+void put_name(ostream &out, string_view name)
+{
+    put32(out, uint32_t(name.size()));
+    out.write(name.data(), name.size());
+}
+
+bool get_magic(istream &in, const char (&magic)[4])
+{
+    char bytes[4];
+    return in.read(bytes, sizeof bytes) and equal(bytes, bytes + 4, magic);
+}
+
+/* the whole of a buffer through a socket, however it is split */
+bool write_all(int fd, const void *data, size_t bytes)
+{
+    const char *p = static_cast<const char *>(data);
+    while (bytes > 0) {
+        ssize_t n = write(fd, p, bytes);
+        if (n < 0 and errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        bytes -= n;
+    }
+    return true;
+}
+
+bool read_all(int fd, void *data, size_t bytes)
+{
+    char *p = static_cast<char *>(data);
+    while (bytes > 0) {
+        ssize_t n = read(fd, p, bytes);
+        if (n < 0 and errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        bytes -= n;
+    }
+    return true;
+}
+
+bool write_words(int fd, const vector<uint32_t> &words)
+{
+    uint32_t count = words.size();
+    return write_all(fd, &count, sizeof count) and
+           write_all(fd, words.data(), words.size() * sizeof(uint32_t));
+}
+
+bool read_words(int fd, vector<uint32_t> &words)
+{
+    uint32_t count;
+    if (not read_all(fd, &count, sizeof count)) {
+        return false;
+    }
+    words.resize(count);
+    return read_all(fd, words.data(), count * sizeof(uint32_t));
+}
+
+/* one shard's artists, their adjacency lists and their search state;
+ * global artist v is local artist v / shards */
+class ShardWorker {
+    public:
+        bool load(const string &file);
+        void serve(int fd);
+
+    private:
+        bool owns(VertexId v) const { return v % shards == index; }
+        bool visited(VertexId v) const
+        {
+            return stamp[v / shards] == search;
+        }
+        void visit(VertexId v, VertexId parent, SongId song);
+
+        void reset(const vector<uint32_t> &request);
+        void expand(const vector<uint32_t> &request,
+                    vector<uint32_t> &reply);
+        void claim(vector<uint32_t> &request, vector<uint32_t> &reply);
+
+        uint32_t shards = 1, index = 0;
+        vector<uint64_t> offsets;
+        vector<VertexId> neighbors;
+        vector<SongId>   songs;
+
+        /* an artist is visited in this search iff its stamp is
+         * 'search', so a new search need not clear anything */
+        uint32_t search = 0;
+        vector<uint32_t> stamp;
+        vector<VertexId> parents;
+        vector<SongId>   parentSongs;
+
+        /* the EXPAND that last sent an edge to each artist, of every
+         * shard, so each sends at most one per artist and level */
+        uint32_t level = 0;
+        vector<uint32_t> sent;
+};
+
+/*
+ * @function: ShardWorker::load
+ * @purpose: Reads a shard file written by write_shards.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: The worker holds the shard's adjacency lists.
+ *
+ * @parameters: file - The shard file (const string&).
+ *
+ * @returns: False iff the file could not be opened or is malformed.
+ */
+
+bool ShardWorker::load(const string &file)
+{
+    ifstream in(file, ios::binary);
+    uint32_t artists, owned;
+    if (not get_magic(in, SHARD_MAGIC) or not get32(in, shards) or
+        not get32(in, index) or not get32(in, artists) or
+        not get32(in, owned) or shards == 0) {
+        return false;
+    }
+    offsets.resize(owned + 1);
+    for (uint64_t &offset : offsets) {
+        if (not get64(in, offset)) {
+            return false;
+        }
+    }
+    neighbors.resize(offsets.back());
+    songs.resize(offsets.back());
+    for (size_t i = 0; i < neighbors.size(); i++) {
+        if (not get32(in, neighbors[i]) or not get32(in, songs[i]) or
+            neighbors[i] >= artists) {
+            return false;
+        }
+    }
+    stamp.assign(owned, 0);
+    sent.assign(artists, 0);
+    parents.resize(owned);
+    parentSongs.resize(owned);
+    return true;
+}
+
+void ShardWorker::visit(VertexId v, VertexId parent, SongId song)
+{
+    stamp[v / shards] = search;
+    parents[v / shards] = parent;
+    parentSongs[v / shards] = song;
+}
+
+/*
+ * @function: ShardWorker::serve
+ * @purpose: Answers the coordinator's requests until it hangs up.
+ *
+ * @preconditions: The shard is loaded; 'fd' is the worker's end of
+ * its socket pair.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: fd - The socket (int).
+ *
+ * @returns: None.
+ */
+
+void ShardWorker::serve(int fd)
+{
+    vector<uint32_t> request, reply;
+    uint32_t type;
+    while (read_all(fd, &type, sizeof type) and read_words(fd, request)) {
+        reply.clear();
+        if (type == RESET) {
+            reset(request);
+        } else if (type == EXPAND) {
+            expand(request, reply);
+        } else if (type == CLAIM) {
+            claim(request, reply);
+        } else if (type == PARENT and request.size() == 1 and
+                   owns(request[0])) {
+            reply.push_back(parents[request[0] / shards]);
+            reply.push_back(parentSongs[request[0] / shards]);
+        }
+        if (not write_words(fd, reply)) {
+            return;
+        }
+    }
+}
+
+void ShardWorker::reset(const vector<uint32_t> &request)
+{
+    if (++search == 0) {
+        fill(stamp.begin(), stamp.end(), 0);
+        search = 1;
+    }
+    for (VertexId v : request) {
+        visit(v, ShardCoordinator::NO_VERTEX, 0);
+    }
+}
+
+/* the first edge out of the listed frontier artists to each artist
+ * not known to be visited; the frontier comes in rank order, so that
+ * is the best edge this shard has to offer */
+void ShardWorker::expand(const vector<uint32_t> &request,
+                         vector<uint32_t> &reply)
+{
+    if (++level == 0) {
+        fill(sent.begin(), sent.end(), 0);
+        level = 1;
+    }
+    for (size_t i = 0; i + 1 < request.size(); i += 2) {
+        VertexId v = request[i];
+        uint32_t rank = request[i + 1];
+        uint64_t begin = offsets[v / shards], end = offsets[v / shards + 1];
+        for (uint64_t e = begin; e < end; e++) {
+            VertexId n = neighbors[e];
+            if ((owns(n) and visited(n)) or sent[n] == level) {
+                continue;
+            }
+            sent[n] = level;
+            reply.insert(reply.end(),
+                         { n, v, songs[e], rank, uint32_t(e - begin) });
+        }
+    }
+}
+
+/* of the edges reaching each unvisited artist, the earliest in
+ * frontier order wins; the winners are sent back in that order */
+void ShardWorker::claim(vector<uint32_t> &request, vector<uint32_t> &reply)
+{
+    size_t count = request.size() / EDGE_WORDS;
+    vector<uint32_t> order(count);
+    for (size_t i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    const uint32_t *edges = request.data();
+    auto key = [edges](uint32_t i) {
+        const uint32_t *e = edges + i * EDGE_WORDS;
+        return make_tuple(e[0], e[3], e[4]);
+    };
+    sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return key(a) < key(b);
+    });
+    for (uint32_t i : order) {
+        const uint32_t *e = edges + i * EDGE_WORDS;
+        if (visited(e[0])) {
+            continue;
+        }
+        visit(e[0], e[1], e[2]);
+        reply.insert(reply.end(), { e[0], e[3], e[4] });
+    }
+}
+
+}
+
+/*
+ * @function: write_shards
+ * @purpose: Splits a packed graph into shard files.
+ *
+ * @preconditions: 'shards' is at least 1.
+ *
+ * @postconditions: 'prefix'.names holds "SDSN", the shard count, the
+ * artist count and every artist name, then the song count and every
+ * song title, each as its length and bytes. 'prefix'.k, for each
+ * shard k, holds "SDSH", the shard count, k, the artist count, the
+ * number of artists v with v % shards == k, and for those artists in
+ * order the offsets (64-bit) of their lists followed by every list
+ * as (neighbor, song) pairs, in the order for_each_neighbor gives
+ * them. Fields are 32-bit unless noted, all little-endian.
+ *
+ * @parameters: graph - The graph to split (const CompactGraph&),
+ * shards - How many shards (size_t), prefix - The start of every
+ * file name (const string&).
+ *
+ * @returns: False iff a file could not be written.
+ */
+
+bool write_shards(const CompactGraph &graph, size_t shards,
+                  const string &prefix)
+{
+    uint32_t artists = graph.vertex_count();
+    ofstream names(prefix + ".names", ios::binary);
+    names.write(NAMES_MAGIC, 4);
+    put32(names, uint32_t(shards));
+    put32(names, artists);
+    for (VertexId v = 0; v < artists; v++) {
+        put_name(names, graph.vertex_name(v));
+    }
+    put32(names, uint32_t(graph.song_count()));
+    for (SongId s = 0; s < graph.song_count(); s++) {
+        put_name(names, graph.song_name(s));
+    }
+    if (not names.flush()) {
+        return false;
+    }
+
+    for (uint32_t k = 0; k < shards; k++) {
+        ofstream shard(prefix + "." + to_string(k), ios::binary);
+        uint32_t owned = artists > k ? (artists - k - 1) / shards + 1 : 0;
+        shard.write(SHARD_MAGIC, 4);
+        put32(shard, uint32_t(shards));
+        put32(shard, k);
+        put32(shard, artists);
+        put32(shard, owned);
+
+        uint64_t offset = 0;
+        put64(shard, offset);
+        for (VertexId v = k; v < artists; v += shards) {
+            offset += graph.degree(v);
+            put64(shard, offset);
+        }
+        for (VertexId v = k; v < artists; v += shards) {
+            graph.for_each_neighbor(v, [&](VertexId n, SongId song) {
+                put32(shard, n);
+                put32(shard, song);
+                return true;
+            });
+        }
+        if (not shard.flush()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ShardCoordinator::ShardCoordinator()
+    : artistIndex(pmr::get_default_resource())
+{
+
+}
+
+/*
+ * @function: ShardCoordinator::open
+ * @purpose: Starts a worker process for each shard written under
+ * 'prefix', and loads the names.
+ *
+ * @preconditions: No other threads are running yet, since the
+ * workers are forked from this process.
+ *
+ * @postconditions: Each worker has loaded its shard and waits for
+ * searches.
+ *
+ * @parameters: prefix - The prefix given to write_shards
+ * (const string&).
+ *
+ * @returns: The coordinator, or nullptr if a file is missing or
+ * malformed (unique_ptr<ShardCoordinator>).
+ */
+
+unique_ptr<ShardCoordinator> ShardCoordinator::open(const string &prefix)
+{
+    unique_ptr<ShardCoordinator> coordinator(new ShardCoordinator());
+    ifstream names(prefix + ".names", ios::binary);
+    uint32_t shards;
+    if (not get_magic(names, NAMES_MAGIC) or not get32(names, shards) or
+        shards == 0) {
+        return nullptr;
+    }
+    names.close();
+
+    /* workers start before the names are read, so they do not
+     * inherit a copy of them */
+    for (uint32_t k = 0; k < shards; k++) {
+        int ends[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, ends) != 0) {
+            return nullptr;
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            /* only this worker's end stays open, so every worker sees
+             * the coordinator hang up */
+            close(ends[0]);
+            for (int fd : coordinator->sockets) {
+                close(fd);
+            }
+            ShardWorker worker;
+            bool loaded = worker.load(prefix + "." + to_string(k));
+            char status = loaded ? 1 : 0;
+            if (write_all(ends[1], &status, 1) and loaded) {
+                worker.serve(ends[1]);
+            }
+            _exit(0);
+        }
+        close(ends[1]);
+        if (pid < 0) {
+            close(ends[0]);
+            return nullptr;
+        }
+        coordinator->sockets.push_back(ends[0]);
+        coordinator->workers.push_back(pid);
+    }
+
+    for (int fd : coordinator->sockets) {
+        char status = 0;
+        if (not read_all(fd, &status, 1) or status != 1) {
+            return nullptr;
+        }
+    }
+    if (not coordinator->load_names(prefix + ".names")) {
+        return nullptr;
+    }
+    return coordinator;
+}
+
+/*
+ * @function: ShardCoordinator::~ShardCoordinator
+ * @purpose: Stops the workers.
+ *
+ * @preconditions: No search is running.
+ *
+ * @postconditions: Every socket is closed and every worker has
+ * exited.
+ *
+ * @parameters: None.
+ *
+ * @returns: None.
+ */
+
+ShardCoordinator::~ShardCoordinator()
+{
+    for (int fd : sockets) {
+        close(fd);
+    }
+    for (pid_t pid : workers) {
+        waitpid(pid, nullptr, 0);
+    }
+}
+
+bool ShardCoordinator::load_names(const string &file)
+{
+    ifstream in(file, ios::binary);
+    uint32_t shards, count;
+    if (not get_magic(in, NAMES_MAGIC) or not get32(in, shards)) {
+        return false;
+    }
+
+    /* two passes: first the sizes, so the views never move */
+    streampos start = in.tellg();
+    size_t bytes = 0;
+    for (int list = 0; list < 2; list++) {
+        if (not get32(in, count)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t size;
+            if (not get32(in, size) or not in.seekg(size, ios::cur)) {
+                return false;
+            }
+            bytes += size;
+        }
+    }
+    nameBytes.resize(bytes);
+    in.seekg(start);
+
+    char *p = nameBytes.data();
+    for (pmr::vector<string_view> *names : { &artistNames, &songNames }) {
+        get32(in, count);
+        names->reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t size;
+            get32(in, size);
+            if (not in.read(p, size)) {
+                return false;
+            }
+            names->push_back(string_view(p, size));
+            p += size;
+        }
+    }
+    artistIndex.build(artistNames);
+    return true;
+}
+
+size_t ShardCoordinator::shard_count() const
+{
+    return sockets.size();
+}
+
+size_t ShardCoordinator::vertex_count() const
+{
+    return artistNames.size();
+}
+
+ShardCoordinator::VertexId
+ShardCoordinator::find_vertex(string_view name) const
+{
+    return artistIndex.find(name);
+}
+
+string_view ShardCoordinator::vertex_name(VertexId v) const
+{
+    return artistNames[v];
+}
+
+string_view ShardCoordinator::song_name(SongId s) const
+{
+    return songNames[s];
+}
+
+void ShardCoordinator::send(size_t shard, uint32_t type,
+                            const vector<uint32_t> &words)
+{
+    if (not write_all(sockets[shard], &type, sizeof type) or
+        not write_words(sockets[shard], words)) {
+        cerr << "Error: lost shard worker " << shard << endl;
+        exit(1);
+    }
+}
+
+void ShardCoordinator::receive(size_t shard, vector<uint32_t> &words)
+{
+    if (not read_words(sockets[shard], words)) {
+        cerr << "Error: lost shard worker " << shard << endl;
+        exit(1);
+    }
+}
+
+/*
+ * @function: ShardCoordinator::shortest_path
+ * @purpose: Breadth-first search across the shards.
+ *
+ * @preconditions: Every id names an artist.
+ *
+ * @postconditions: If a path exists that avoids 'excluded', 'path'
+ * and 'songs' hold the one a search in one process would report.
+ * Searches from several threads take turns.
+ *
+ * @parameters: from, to - The artists to join (VertexId), excluded -
+ * Artists the path may not pass through (const vector<VertexId>&),
+ * path - Set to the artists on the path (vector<VertexId>&), songs -
+ * Set to the songs joining them (vector<SongId>&), stop - Ends the
+ * search early, between levels, or nullptr (const StopToken*).
+ *
+ * @returns: True iff a path was found.
+ *
+ * @notes: Each level takes two rounds of messages: the frontier goes
+ * out to be expanded, and the edges found go to the owners of the
+ * artists they reach. Requests go to every worker before any reply
+ * is read, so the workers run at the same time, and each reads a
+ * whole request before it replies, so neither side waits on the
+ * other forever.
+ */
+
+bool ShardCoordinator::shortest_path(VertexId from, VertexId to,
+                                     const vector<VertexId> &excluded,
+                                     vector<VertexId> &path,
+                                     vector<SongId> &songs,
+                                     const StopToken *stop)
+{
+    path.clear();
+    songs.clear();
+    if (from == to or
+        find(excluded.begin(), excluded.end(), from) != excluded.end()) {
+        return false;
+    }
+
+    lock_guard<mutex> guard(lock);
+    size_t shards = sockets.size();
+    vector<vector<uint32_t>> out(shards);
+    vector<uint32_t> reply;
+
+    out[from % shards].push_back(from);
+    for (VertexId v : excluded) {
+        out[v % shards].push_back(v);
+    }
+    for (size_t k = 0; k < shards; k++) {
+        send(k, RESET, out[k]);
+    }
+    for (size_t k = 0; k < shards; k++) {
+        receive(k, reply);
+    }
+
+    /* the frontier in search order; an artist's rank is its index */
+    vector<VertexId> frontier = { from };
+    /* (rank, index, n) of each artist reached this level */
+    vector<tuple<uint32_t, uint32_t, VertexId>> reached;
+    bool found = false;
+    while (not frontier.empty() and not found) {
+        if (stop != nullptr and stop->cancelled()) {
+            return false;
+        }
+
+        for (vector<uint32_t> &words : out) {
+            words.clear();
+        }
+        for (uint32_t rank = 0; rank < frontier.size(); rank++) {
+            out[frontier[rank] % shards].push_back(frontier[rank]);
+            out[frontier[rank] % shards].push_back(rank);
+        }
+        for (size_t k = 0; k < shards; k++) {
+            send(k, EXPAND, out[k]);
+        }
+
+        /* each edge found goes to the shard owning its far end */
+        for (vector<uint32_t> &words : out) {
+            words.clear();
+        }
+        for (size_t k = 0; k < shards; k++) {
+            receive(k, reply);
+            for (size_t i = 0; i + EDGE_WORDS <= reply.size();
+                 i += EDGE_WORDS) {
+                vector<uint32_t> &owner = out[reply[i] % shards];
+                owner.insert(owner.end(), reply.begin() + i,
+                             reply.begin() + i + EDGE_WORDS);
+            }
+        }
+        for (size_t k = 0; k < shards; k++) {
+            send(k, CLAIM, out[k]);
+        }
+
+        reached.clear();
+        for (size_t k = 0; k < shards; k++) {
+            receive(k, reply);
+            for (size_t i = 0; i + 3 <= reply.size(); i += 3) {
+                reached.emplace_back(reply[i + 1], reply[i + 2],
+                                     reply[i]);
+                found = found or reply[i] == to;
+            }
+        }
+        sort(reached.begin(), reached.end());
+        frontier.clear();
+        for (const auto &r : reached) {
+            frontier.push_back(get<2>(r));
+        }
+    }
+    if (not found) {
+        return false;
+    }
+
+    /* walk back from 'to', asking each artist's owner for its parent */
+    path.push_back(to);
+    while (path.back() != from) {
+        VertexId v = path.back();
+        send(v % shards, PARENT, { v });
+        receive(v % shards, reply);
+        path.push_back(reply[0]);
+        songs.push_back(reply[1]);
+    }
+    reverse(path.begin(), path.end());
+    reverse(songs.begin(), songs.end());
+    return true;
+}
@@ -0,0 +1,98 @@
+/*
+ * ShardedSearch.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Breadth-first search over a graph split across several processes,
+ *   for datasets whose adjacency does not fit in one.
+ *
+ *   write_shards splits a packed graph by vertex: artist v belongs to
+ *   shard v % N, and shard k's file holds the adjacency lists of just
+ *   its artists. A separate names file holds every artist name and
+ *   song title, which is all the coordinating process keeps.
+ *
+ *   ShardCoordinator::open forks one worker per shard, each talking to
+ *   the coordinator over a Unix socket pair. A worker loads its shard
+ *   and keeps the visited marks and predecessors of its own artists.
+ *   A search goes level by level: every worker expands its part of the
+ *   frontier and returns the edges it found, the coordinator sends
+ *   each edge to the worker owning its far end, and that worker keeps
+ *   the ones reaching artists not yet visited. Each frontier artist
+ *   carries its rank in the level, and an artist reached by several
+ *   edges keeps the one from the lowest ranked artist (and earliest in
+ *   its adjacency list), so the paths are exactly those a search in
+ *   one process finds.
+ */
+#ifndef __SHARDED_SEARCH__
+#define __SHARDED_SEARCH__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/types.h>
+
+#include "CompactGraph.h"
+#include "NameIndex.h"
+#include "Traversal.h"
+
+bool write_shards(const CompactGraph &graph, size_t shards,
+                  const std::string &prefix);
+
+class ShardCoordinator {
+    public:
+        typedef uint32_t VertexId;
+        typedef uint32_t SongId;
+
+        static const VertexId NO_VERTEX = UINT32_MAX;
+
+        static std::unique_ptr<ShardCoordinator>
+        open(const std::string &prefix);
+        ~ShardCoordinator();
+
+        ShardCoordinator(const ShardCoordinator &) = delete;
+        ShardCoordinator &operator=(const ShardCoordinator &) = delete;
+
+        size_t shard_count() const;
+        size_t vertex_count() const;
+
+        VertexId         find_vertex(std::string_view name) const;
+        std::string_view vertex_name(VertexId v) const;
+        std::string_view song_name(SongId s) const;
+
+        /* path[0] is 'from' and the last entry 'to'; songs[i] joins
+         * path[i] and path[i + 1] */
+        bool shortest_path(VertexId from, VertexId to,
+                           const std::vector<VertexId> &excluded,
+                           std::vector<VertexId> &path,
+                           std::vector<SongId> &songs,
+                           const StopToken *stop = nullptr);
+
+    private:
+        ShardCoordinator();
+
+        bool load_names(const std::string &file);
+        void send(size_t shard, uint32_t type,
+                  const std::vector<uint32_t> &words);
+        void receive(size_t shard, std::vector<uint32_t> &words);
+
+        /* one socket and process per shard */
+        std::vector<int>   sockets;
+        std::vector<pid_t> workers;
+
+        /* every name, back to back; names[v] views into it */
+        std::string nameBytes;
+        std::pmr::vector<std::string_view> artistNames;
+        std::pmr::vector<std::string_view> songNames;
+        NameIndex artistIndex;
+
+        std::mutex lock;     /* one search at a time on the sockets */
+};
+
+#endif /* __SHARDED_SEARCH__ */
@@ -5,6 +5,7 @@
  * 
  * by Iman Enayati, April 18th 2024
  */
+#include <algorithm>
 #include <iostream>
 #include <stack>
 #include <vector>
@@ -12,10 +13,22 @@
 #include <unordered_map>
 #include <functional>
 #include <exception>
+#include <stdexcept>
+#include <memory>
+#include <memory_resource>
+#include <chrono>
+#include <fstream>
+#include <cstdio>
 
 #include "SixDegrees.h"
 #include "Artist.h"
 #include "CollabGraph.h"
+#include "ColumnarExport.h"
+#include "DistanceMatrix.h"
+#include "FrontierKernel.h"
+#include "EdgeBuilder.h"
+#include "Parallel.h"
+#include "SearchCore.h"
 
 using namespace std;
 
@@ -38,6 +51,12 @@ using namespace std;
 SixDegrees::SixDegrees()
 {
     graph = CollabGraph();
+    auto empty = make_shared<GraphSnapshot>();
+    empty->graph = make_unique<CompactGraph>();
+    empty->credits = make_unique<SongCredits>(*empty->graph,
+                                              vector<Artist *>());
+    publish(std::move(empty));
+    threads = default_threads();
     output = &cout;
 }
 
@@ -50,21 +69,83 @@ SixDegrees::SixDegrees()
  *
  * @postconditions: The graph is populated with 
  * artists from 'artistList', and edges are set 
- * based on their collaborations.
+ * based on their collaborations, in parallel from 
+ * a song index when the dataset allows it (see 
+ * EdgeBuilder.h) and with setEdges otherwise; the 
+ * graph is the same either way. The packed copy
+ * used by searches and its song credits are rebuilt,
+ * and so is the name matcher if configureLookup 
+ * asked for one. When 
+ * configureBipartite asked for song credits, and the 
+ * dataset allows it, the packed copy is built from 
+ * them instead and the CollabGraph gets no edges. 
+ * The time each step took is kept for profileLoad.
+ * The graph is rebuilt from 'artistList' alone, so a
+ * loader may call this again with a longer list: the 
+ * new packed copy and matcher are published as the 
+ * next version, and queries that started on an older 
+ * one finish on it. Builds, whether from a loader or 
+ * reload_function, take turns.
  *
  * @parameters: artistList - A list of pointers 
  * to artists (vector<Artist*>).
  *
- * @returns: None.
+ * @returns: The version published (size_t).
  */
 
-void SixDegrees::populateGraph(vector<Artist *> artistList)
+size_t SixDegrees::populateGraph(vector<Artist *> artistList)
 {
+    typedef chrono::duration<double, milli> Millis;
+    lock_guard<mutex> guard(loading);
+    Clock::time_point start = Clock::now();
+
+    graph = CollabGraph();
+    auto next = make_shared<GraphSnapshot>();
+    next->version = snapshot()->version + 1;
+    unique_ptr<CompactGraph> &compact = next->graph;
     for (Artist *artistToAdd : artistList) {
         graph.insert_vertex(*artistToAdd);
     }
+    Clock::time_point inserted = Clock::now();
+
+    /* song credits, when asked for, stand in for the edges */
+    if (songCredits) {
+        compact = CompactGraph::bipartite(artistList);
+    }
+    if (compact == nullptr) {
+        CollabEdges edges;
+        if (buildCollabEdges(artistList, threads, edges)) {
+            graph.insert_edges(artistList, edges, threads);
+        } else {
+            setEdges(artistList);
+        }
+    }
+    Clock::time_point connected = Clock::now();
 
-    setEdges(artistList);
+    if (compact == nullptr) {
+        compact = make_unique<CompactGraph>(graph);
+        if (vertexOrder != VertexOrder::INSERTION) {
+            compact = compact->relabeled(vertexOrder);
+        }
+        if (compressAdjacency) {
+            compact = compact->compressed();
+        }
+    }
+    next->credits = make_unique<SongCredits>(*compact, artistList);
+    Clock::time_point packed = Clock::now();
+
+    if (foldNames or suggestions > 0) {
+        next->matcher = make_unique<NameMatcher>(*compact, threads);
+    }
+    Clock::time_point indexed = Clock::now();
+    size_t version = next->version;
+    publish(std::move(next));
+
+    loadTimes.insertMs = Millis(inserted - start).count();
+    loadTimes.edgeMs   = Millis(connected - inserted).count();
+    loadTimes.packMs   = Millis(packed - connected).count();
+    loadTimes.indexMs  = Millis(indexed - packed).count();
+    return version;
 }
 
 /*
@@ -119,7 +200,8 @@ void SixDegrees::setEdges(vector<Artist *> artistList)
 
 void SixDegrees::print()
 {
-    graph.print_graph(*output);
+    lock_guard<mutex> guard(loading);
+    graph.print_graph_parallel(*output, threads);
 }
 
 /*
@@ -129,8 +211,8 @@ void SixDegrees::print()
  *
  * @preconditions: None.
  *
- * @postconditions: Metadata related to graph 
- * traversal is cleared, including pathFound flag.
+ * @postconditions: The visited marks and 
+ * predecessors of the graph are cleared.
  *
  * @parameters: None.
  *
@@ -140,7 +222,6 @@ void SixDegrees::print()
 void SixDegrees::clear_metadata()
 {
     graph.clear_metadata();
-    pathFound = false;
 }
 
 /*
@@ -163,39 +244,56 @@ void SixDegrees::clear_metadata()
 
 void SixDegrees::bfs_function(const Artist &from, const Artist &to)
 {
-    queue<Artist> q;
-    vector<Artist> neighbors;
+    bfs_function(from, to, *output);
+}
+
+/*
+ * @function: bfs_function
+ * @purpose: Conducts breadth-first search 
+ * (BFS) traversal to find a path between two artists.
+ *
+ * @preconditions: The graph is initialized and 
+ * contains vertices representing artists.
+ *
+ * @postconditions: If a path between 'from' and 
+ * 'to' is found, it's printed to 'out'. If not, an 
+ * appropriate message is printed.
+ *
+ * @parameters: from - The starting artist 
+ * (const Artist&), to - The target artist (const Artist&),
+ * out - Where the result is printed (ostream&), stop - Ends 
+ * the search early, or nullptr (const StopToken*).
+ *
+ * @returns: None.
+ */
 
-    if (not validate_from_to(from, to)) {
+void SixDegrees::bfs_function(const Artist &from, const Artist &to,
+                              ostream &out, const StopToken *stop)
+{
+    if (shards != nullptr) {
+        sharded_path(from, to, vector<Artist>(), out, stop);
+        return;
+    }
+    SnapshotPtr snap = snapshot();
+    VertexId source, dest;
+    if (not validate_from_to(*snap, from, to, source, dest, out)) {
         return;
     }
 
-    q.push(from);
-    while (!q.empty()) {
-        Artist curArtist = q.front();
-        q.pop();
-        if (graph.is_marked(curArtist)) {
-            continue; //discard
-        }
-        graph.mark_vertex(curArtist);
+    WorkspacePool::Lease ws = workspaces.acquire(snap->graph->vertex_count());
+    ws->watch(stop, budget);
 
-        if (curArtist == to) {
-            print_path(from,to);
-            clear_metadata();
-            return;
-        }
-        neighbors = graph.get_vertex_neighbors(curArtist);
-        for (size_t i = 0; i < neighbors.size(); i++) {
-            if (graph.is_marked(neighbors[i]) == false) {
-                graph.set_predecessor(neighbors[i], curArtist);
-                q.push(neighbors[i]);
-            }
-        }
+    QueryRecord query;
+    query.command = "bfs";
+    Clock::time_point start = metrics_clock();
+    query.found = shortest_path(*snap, *ws, source, dest);
+    Clock::time_point searched = metrics_clock();
+    if (not query.found and report_stop(*snap, *ws, source, dest, out)) {
+        record_query(*snap, query, *ws, source, dest, 0, start, searched);
+        return;
     }
-
-    print_path(from, to);
-    clear_metadata();
-    return;
+    query.pathLength = print_path(*snap, *ws, source, dest, query.found, out);
+    record_query(*snap, query, *ws, source, dest, 0, start, searched);
 }
 
 /*
@@ -219,17 +317,53 @@ void SixDegrees::bfs_function(const Artist &from, const Artist &to)
 
 void SixDegrees::dfs_function(const Artist &from, const Artist &to)
 {
-    if (not validate_from_to(from, to)) {
+    dfs_function(from, to, *output);
+}
+
+/*
+ * @function: dfs_function
+ * @purpose: Conducts depth-first search (DFS) 
+ * traversal to find a path between two artists.
+ *
+ * @preconditions: The graph is initialized and 
+ * contains vertices representing artists.
+ *
+ * @postconditions: If a path between 'from' and 
+ * 'to' is found, it's printed to 'out'. If not, an 
+ * appropriate message is printed.
+ *
+ * @parameters: from - The starting artist 
+ * (const Artist&), to - The target artist 
+ * (const Artist&), out - Where the result is printed 
+ * (ostream&), stop - Ends the search early, or nullptr 
+ * (const StopToken*).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::dfs_function(const Artist &from, const Artist &to,
+                              ostream &out, const StopToken *stop)
+{
+    SnapshotPtr snap = snapshot();
+    VertexId source, dest;
+    if (not validate_from_to(*snap, from, to, source, dest, out)) {
         return;
     }
 
-    clear_metadata();
-    Artist nullArtist = Artist();
-    dfs_private(from, nullArtist, from, to);
-    if (!pathFound) {
-        print_path(from, to);
+    WorkspacePool::Lease ws = workspaces.acquire(snap->graph->vertex_count());
+    ws->watch(stop, budget);
+
+    QueryRecord query;
+    query.command = "dfs";
+    Clock::time_point start = metrics_clock();
+    query.found = depth_first_path(*snap, *ws, source, dest);
+    Clock::time_point searched = metrics_clock();
+    if (not query.found and report_stop(*snap, *ws, source, dest, out)) {
+        record_query(*snap, query, *ws, source, dest, 0, start, searched);
         return;
     }
+    query.pathLength = print_path(*snap, *ws, source, dest, query.found, out);
+    record_query(*snap, query, *ws, source, dest, 0, start, searched);
 }
 
 /*
@@ -246,241 +380,1488 @@ void SixDegrees::dfs_function(const Artist &from, const Artist &to)
  * @parameters: from - The starting artist 
  * (const Artist&), to - The target artist (const Artist&),
  *              notList - A list of artists to 
- * exclude from consideration (vector<Artist>).
+ * exclude from consideration (const vector<Artist>&).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::not_function(const Artist &from, const Artist &to, 
+                                          const vector<Artist> &notList)
+{
+    not_function(from, to, notList, *output);
+}
+
+/*
+ * @function: not_function
+ * @purpose: Finds the shortest path between two 
+ * artists, excluding specified artists from consideration.
+ *
+ * @preconditions: The graph is initialized and 
+ * contains vertices representing artists.
+ *
+ * @postconditions: The shortest path between 
+ * 'from' and 'to' is found, excluding artists in 'notList',
+ * and printed to 'out'.
+ *
+ * @parameters: from - The starting artist 
+ * (const Artist&), to - The target artist (const Artist&),
+ *              notList - A list of artists to 
+ * exclude from consideration (const vector<Artist>&),
+ *              out - Where the result is printed (ostream&),
+ *              stop - Ends the search early, or nullptr 
+ * (const StopToken*).
  *
  * @returns: None.
  */
 
 void SixDegrees::not_function(const Artist &from, const Artist &to, 
-                                                vector<Artist> notList)
+                              const vector<Artist> &notList, ostream &out,
+                              const StopToken *stop)
 {
-    clear_metadata();
-    bool returnValue = validate_from_to(from, to);
-    bool validateValue = validateList(notList);
+    if (shards != nullptr) {
+        sharded_path(from, to, notList, out, stop);
+        return;
+    }
+    SnapshotPtr snap = snapshot();
+    VertexId source, dest;
+    bool returnValue = validate_from_to(*snap, from, to, source, dest, out);
+    bool validateValue = validateList(*snap, notList, out);
 
     if (!returnValue or !validateValue) {
         return;
     }
 
+    WorkspacePool::Lease ws = workspaces.acquire(snap->graph->vertex_count());
+
+    /* excluded artists are marked up front so the search never
+     * enters them; the budget is watched from after them, so they
+     * do not use it up */
     for (size_t i = 0; i < notList.size(); i++) {
-        exclude(notList[i]);
+        VertexId excluded = find_artist(*snap, notList[i].get_name());
+        if (not ws->is_visited(excluded)) {
+            ws->visit(excluded, CompactGraph::NO_VERTEX, 0);
+        }
     }
+    size_t excluded = ws->visit_count();
+    ws->watch(stop, budget);
 
-    bfs_function(from, to);
-    clear_metadata();
+    QueryRecord query;
+    query.command = "not";
+    Clock::time_point start = metrics_clock();
+    query.found = shortest_path(*snap, *ws, source, dest);
+    Clock::time_point searched = metrics_clock();
+    if (not query.found and report_stop(*snap, *ws, source, dest, out)) {
+        record_query(*snap, query, *ws, source, dest, excluded, start,
+                     searched);
+        return;
+    }
+    query.pathLength = print_path(*snap, *ws, source, dest, query.found, out);
+    record_query(*snap, query, *ws, source, dest, excluded, start, searched);
 }
 
 /*
- * @function: exclude
- * @purpose: Marks an artist as excluded from 
- * the graph traversal.
+ * @function: through_function
+ * @purpose: Finds the shortest path between two artists that 
+ * only uses collaborations on the given songs.
  *
- * @preconditions: None.
+ * @preconditions: The graph is initialized and 
+ * contains vertices representing artists.
  *
- * @postconditions: The provided artist is 
- * marked as excluded from further traversal.
+ * @postconditions: See song_path.
  *
- * @parameters: exclude - The artist to be 
- * excluded (const Artist&).
+ * @parameters: from - The starting artist (const Artist&), 
+ * to - The target artist (const Artist&), songs - The songs 
+ * the path may use (const vector<string>&), out - Where the 
+ * result is printed, 'output' if not given (ostream&), stop - 
+ * Ends the search early, or nullptr (const StopToken*).
  *
  * @returns: None.
  */
 
-void SixDegrees::exclude(const Artist &exclude)
+void SixDegrees::through_function(const Artist &from, const Artist &to,
+                                  const vector<string> &songs)
 {
-    graph.mark_vertex(exclude);
+    through_function(from, to, songs, *output);
+}
+
+void SixDegrees::through_function(const Artist &from, const Artist &to,
+                                  const vector<string> &songs, ostream &out,
+                                  const StopToken *stop)
+{
+    SnapshotPtr snap = snapshot();
+    song_path(*snap, "through", from, to, songs, true, out, stop);
 }
 
 /*
- * @function: configureOutput
- * @purpose: Configures the output stream 
- * for printing messages.
+ * @function: avoid_function
+ * @purpose: Finds the shortest path between two artists that 
+ * uses no collaboration on the given songs.
  *
- * @preconditions: None.
+ * @preconditions: The graph is initialized and 
+ * contains vertices representing artists.
  *
- * @postconditions: The 'output' stream is 
- * configured to the provided 'out' stream.
+ * @postconditions: See song_path.
  *
- * @parameters: out - Pointer to the output 
- * stream (ostream*).
+ * @parameters: from - The starting artist (const Artist&), 
+ * to - The target artist (const Artist&), songs - The songs 
+ * the path may not use (const vector<string>&), out - Where 
+ * the result is printed, 'output' if not given (ostream&), 
+ * stop - Ends the search early, or nullptr (const StopToken*).
  *
  * @returns: None.
  */
 
-void SixDegrees::configureOutput(ostream *out)
+void SixDegrees::avoid_function(const Artist &from, const Artist &to,
+                                const vector<string> &songs)
 {
-    output = out;
+    avoid_function(from, to, songs, *output);
+}
+
+void SixDegrees::avoid_function(const Artist &from, const Artist &to,
+                                const vector<string> &songs, ostream &out,
+                                const StopToken *stop)
+{
+    SnapshotPtr snap = snapshot();
+    song_path(*snap, "avoid", from, to, songs, false, out, stop);
 }
 
 /*
- * @function: print_path
- * @purpose: Prints the path between two artists 
- * if it exists.
+ * @function: mbfs_function
+ * @purpose: Finds the shortest path from any of several artists to
+ * any of several others, in a single search.
  *
  * @preconditions: The graph is initialized and 
  * contains vertices representing artists.
  *
- * @postconditions: None.
+ * @postconditions: The closest source and target are named, then the 
+ * path between them is printed as bfs prints paths, to 'out' 
+ * ('output' if not given). Of several equally close pairs, the one 
+ * the search reaches first is reported: sources are expanded in the 
+ * order they are listed. As with bfs, an artist has no path to 
+ * itself, so an artist listed on both sides is only a source. 
+ * Missing artists are reported, and the search is not run.
  *
- * @parameters: from - The starting artist 
- * (const Artist&), to - The target artist 
- * (const Artist&).
+ * @parameters: sources - The artists the path may start from 
+ * (const vector<Artist>&), targets - The artists it may end at 
+ * (const vector<Artist>&), out - Where the result is printed 
+ * (ostream&), stop - Ends the search early, or nullptr 
+ * (const StopToken*).
  *
  * @returns: None.
  */
 
-void SixDegrees::print_path(const Artist &from, const Artist &to)
+void SixDegrees::mbfs_function(const vector<Artist> &sources,
+                               const vector<Artist> &targets)
+{
+    mbfs_function(sources, targets, *output);
+}
+
+void SixDegrees::mbfs_function(const vector<Artist> &sources,
+                               const vector<Artist> &targets, ostream &out,
+                               const StopToken *stop)
 {
-    stack<Artist> reportedPath = graph.report_path(from, to);
-    if (reportedPath.empty()) {
-        *output << "A path does not exist between "
-                << "\"" << from.get_name() << "\"" << " and "
-                << "\"" << to.get_name() << "\"." << endl;
+    SnapshotPtr snap = snapshot();
+    bool sourceValue = validateList(*snap, sources, out);
+    bool targetValue = validateList(*snap, targets, out);
+    if (!sourceValue or !targetValue) {
+        return;
+    }
+
+    /* with no sources or no targets there is nothing to search, and
+     * nothing to record */
+    if (sources.empty() or targets.empty()) {
+        out << "A path does not exist between the sources and the targets."
+            << endl;
+        return;
+    }
+
+    WorkspacePool::Lease ws = workspaces.acquire(snap->graph->vertex_count());
+    ws->watch(stop, budget);
+
+    pmr::vector<VertexId> sourceIds(&ws->arena);
+    pmr::vector<VertexId> targetIds(&ws->arena);
+    for (const Artist &source : sources) {
+        sourceIds.push_back(find_artist(*snap, source.get_name()));
+    }
+    for (const Artist &target : targets) {
+        targetIds.push_back(find_artist(*snap, target.get_name()));
+    }
+    sort(targetIds.begin(), targetIds.end());
+
+    QueryRecord query;
+    query.command = "mbfs";
+    Clock::time_point start = metrics_clock();
+    VertexId reached = nearest_target(*snap, *ws, sourceIds, targetIds);
+    Clock::time_point searched = metrics_clock();
+    if (reached == CompactGraph::NO_VERTEX and
+        report_stop(*snap, *ws, CompactGraph::NO_VERTEX,
+                    CompactGraph::NO_VERTEX, out)) {
+        record_query(*snap, query, *ws, sourceIds.front(),
+                     targetIds.front(), 0, start, searched);
         return;
-    } 
+    }
 
-    while (reportedPath.size() > 1) {
-        Artist a = reportedPath.top();
-        reportedPath.pop();
-        Artist b = reportedPath.top();
+    if (reached == CompactGraph::NO_VERTEX) {
+        out << "A path does not exist between the sources and the targets."
+            << endl;
+        record_query(*snap, query, *ws, sourceIds.front(),
+                     targetIds.front(), 0, start, searched);
+        return;
+    }
 
-        *output << "\"" << a.get_name() << "\"" << " collaborated with "
-                << "\"" << b.get_name() << "\"" << " in "
-                << "\"" << graph.get_edge(a, b) << "\"." << endl;
-        
+    VertexId source = reached;
+    while (ws->predecessor(source) != CompactGraph::NO_VERTEX) {
+        source = ws->predecessor(source);
     }
-    *output << "***" <<endl;
+    out << "The closest pair is \"" << snap->graph->vertex_name(source)
+        << "\" and \"" << snap->graph->vertex_name(reached) << "\"." << endl;
+
+    query.found = true;
+    query.pathLength = print_path(*snap, *ws, source, reached, true, out);
+    record_query(*snap, query, *ws, source, reached, 0, start, searched);
 }
 
 /*
- * @function: validate_from_to
- * @purpose: Validates if both 'from' and 'to' 
- * artists exist in the graph dataset.
+ * @function: matrix_function
+ * @purpose: Writes the degrees of separation between every pair of
+ * artists listed in a file.
  *
  * @preconditions: The graph is initialized and 
  * contains vertices representing artists.
  *
- * @postconditions: None.
+ * @postconditions: 'matrixFile' holds the matrix (see 
+ * DistanceMatrix.h), as CSV if its name ends in ".csv" and in the 
+ * binary format otherwise, and a line saying so is printed to 'out' 
+ * ('output' if not given). The list names one artist per line; blank 
+ * lines are skipped. Missing artists, or a file that cannot be 
+ * opened, are reported and nothing is written.
  *
- * @parameters: from - The starting artist 
- * (const Artist&), to - The target artist (const Artist&).
+ * @parameters: listFile - The artist list (const string&), 
+ * matrixFile - Where the matrix goes (const string&), out - Where 
+ * the result is printed (ostream&), stop - Ends the search 
+ * early, or nullptr (const StopToken*).
  *
- * @returns: True if both 'from' and 'to' 
- * artists exist in the graph dataset, false otherwise.
+ * @returns: None.
  */
 
-bool SixDegrees::validate_from_to(const Artist &from, const Artist &to) {
+void SixDegrees::matrix_function(const string &listFile,
+                                 const string &matrixFile)
+{
+    matrix_function(listFile, matrixFile, *output);
+}
 
-    bool returnValue = true;
-    if (graph.is_vertex(from) == false) {
-        *output << "\"" << from.get_name() << "\"" 
-        << " was not found in the dataset :(" << endl;
-        returnValue = false;
+void SixDegrees::matrix_function(const string &listFile,
+                                 const string &matrixFile, ostream &out,
+                                 const StopToken *stop)
+{
+    SnapshotPtr snap = snapshot();
+    ifstream list(listFile);
+    if (not list.is_open()) {
+        out << "\"" << listFile << "\" could not be opened." << endl;
+        return;
+    }
+    vector<Artist> artists;
+    string line;
+    while (getline(list, line)) {
+        if (not line.empty()) {
+            artists.push_back(Artist(line));
+        }
+    }
+    if (not validateList(*snap, artists, out)) {
+        return;
     }
 
-    if (graph.is_vertex(to) == false) {
-        *output << "\"" << to.get_name() << "\"" 
-        << " was not found in the dataset :(" << endl;
-        returnValue = false;
+    vector<VertexId> ids;
+    for (const Artist &artist : artists) {
+        ids.push_back(find_artist(*snap, artist.get_name()));
     }
-    return returnValue;
+    vector<Distance> distances;
+    StopReason stopped = distance_matrix(*snap->graph, ids, threads, distances,
+                                         stop, budget.deadlineMs);
+    if (stopped == StopReason::CANCELLED) {
+        out << StopToken::MESSAGE << flush;
+        return;
+    }
+    if (stopped == StopReason::BUDGET) {
+        out << "The matrix was not finished within budget." << endl;
+        return;
+    }
+
+    bool csv = matrixFile.size() >= 4 and
+               matrixFile.compare(matrixFile.size() - 4, 4, ".csv") == 0;
+    ofstream file(matrixFile, csv ? ios::out : ios::out | ios::binary);
+    if (not file.is_open()) {
+        out << "\"" << matrixFile << "\" could not be opened." << endl;
+        return;
+    }
+    if (csv) {
+        write_matrix_csv(file, *snap->graph, ids, distances);
+    } else {
+        write_matrix_binary(file, *snap->graph, ids, distances);
+    }
+    out << "Wrote the distances between " << ids.size() 
+        << " artists to \"" << matrixFile << "\"." << endl;
 }
 
 /*
- * @function: validateList
- * @purpose: Validates if all artists in the 
- * provided list exist in the graph dataset.
+ * @function: export_function
+ * @purpose: Writes the graph to a file for other tools to analyze.
  *
- * @preconditions: The graph is initialized and 
- * contains vertices representing artists.
+ * @preconditions: None.
  *
- * @postconditions: None.
+ * @postconditions: 'file' holds every artist, song and collaboration
+ * of the current version in the columnar format (see 
+ * ColumnarExport.h), written on --threads threads, and a line saying 
+ * so is printed to 'out' ('output' if not given). A file that cannot 
+ * be written, or an export cancelled part way, is reported and 
+ * removed.
  *
- * @parameters: List - The list of artists to 
- * validate (vector<Artist>).
+ * @parameters: file - Where the export goes (const string&), out - 
+ * Where the result is printed (ostream&), stop - Ends the export 
+ * early, or nullptr (const StopToken*).
  *
- * @returns: True if all artists in the list 
- * exist in the graph dataset, false otherwise.
+ * @returns: None.
  */
 
-bool SixDegrees::validateList(vector<Artist> List)
+void SixDegrees::export_function(const string &file)
 {
-    bool validateValue = true;
-    for (size_t i = 0; i < List.size(); i++) {
-        if (validateExclude(List[i]) == false) {
-            validateValue = false;
-        }
+    export_function(file, *output);
+}
+
+void SixDegrees::export_function(const string &file, ostream &out,
+                                 const StopToken *stop)
+{
+    SnapshotPtr snap = snapshot();
+    size_t edges = 0;
+    ExportStatus status = export_columnar(*snap->graph, file, threads,
+                                          edges, stop);
+    if (status == ExportStatus::CANCELLED) {
+        out << StopToken::MESSAGE << flush;
+    } else if (status == ExportStatus::FAILED) {
+        out << "\"" << file << "\" could not be written." << endl;
+    } else {
+        out << "Exported " << snap->graph->vertex_count() << " artists, "
+            << snap->graph->song_count() << " songs and " << edges
+            << " collaborations to \"" << file << "\"." << endl;
     }
-    return validateValue;
 }
 
 /*
- * @function: validateExclude
- * @purpose: Validates if the provided artist 
- * exists in the graph dataset.
+ * @function: dump_function
+ * @purpose: Writes every collaboration of the graph to a file as
+ * text, in the format of print.
  *
- * @preconditions: The graph is initialized and 
- * contains vertices representing artists.
+ * @preconditions: None.
  *
- * @postconditions: None.
+ * @postconditions: 'file' holds one "\"A\" collaborated with \"B\" in
+ * \"song\"." line per edge of each artist and then "***", formatted on
+ * --threads threads a bounded piece at a time (see
+ * print_graph_parallel), and a line saying so is printed to 'out'
+ * ('output' if not given). A reload waits for the dump to finish. A
+ * file that cannot be written is reported and removed.
  *
- * @parameters: exclude - The artist to validate 
- * (const Artist&).
+ * @parameters: file - Where the dump goes (const string&), out -
+ * Where the result is printed (ostream&).
  *
- * @returns: True if the provided artist exists 
- * in the graph dataset, false otherwise.
+ * @returns: None.
  */
 
-bool SixDegrees::validateExclude(const Artist &exclude)
+void SixDegrees::dump_function(const string &file)
 {
-    bool validateValue = true;
-    if (graph.is_vertex(exclude) == false) {
-        *output << "\"" << exclude.get_name() << "\"" 
-        << " was not found in the dataset :(" << endl;
-        validateValue = false;
+    dump_function(file, *output);
+}
+
+void SixDegrees::dump_function(const string &file, ostream &out)
+{
+    if (songCredits) {
+        out << "dump is not available with --bipartite." << endl;
+        return;
     }
-    return validateValue;
+    ofstream dump(file, ios::binary | ios::trunc);
+    if (dump.is_open()) {
+        lock_guard<mutex> guard(loading);
+        graph.print_graph_parallel(dump, threads);
+        dump.close();
+    }
+    if (dump.fail()) {
+        remove(file.c_str());
+        out << "\"" << file << "\" could not be written." << endl;
+        return;
+    }
+    out << "Dumped the graph to \"" << file << "\"." << endl;
 }
 
 /*
- * @function: dfs_private
- * @purpose: Conducts depth-first search (DFS) traversal 
- * to find a path from one artist to another within six 
- * degrees of separation.
+ * @function: reload_function
+ * @purpose: Replaces the dataset with the one in another dataFile,
+ * without stopping the queries that are running.
+ *
+ * @preconditions: None.
  *
- * @preconditions: The graph is initialized and contains 
- * vertices representing artists. 'from' and 'to' artists 
- * exist in the graph.
+ * @postconditions: The new graph is built beside the current one and
+ * published as the next version once it is complete, and a line
+ * saying so is printed to 'out' ('output' if not given). Queries
+ * already running finish on the version they started with, which is
+ * freed when the last of them lets go. A file that cannot be opened
+ * or parsed, or a reload cancelled before it is built, is reported
+ * and the current version stays.
  *
- * @postconditions: If a path from 'from' to 'to' is found 
- * within six degrees of separation, it's printed, and 
- * 'pathFound' flag is set to true.
+ * @parameters: dataFile - The new dataset (const string&), out -
+ * Where the result is printed (ostream&), stop - Abandons the reload
+ * if cancelled before the build, or nullptr (const StopToken*).
  *
- * @parameters: curArtist - The current artist, parent - 
- * The parent artist, from - Starting artist, to - Target 
- * artist.
+ * @returns: None.
  */
 
-void SixDegrees::dfs_private(const Artist &curArtist, const Artist &parent, 
-                                         const Artist &from, const Artist &to)
+void SixDegrees::reload_function(const string &dataFile)
+{
+    reload_function(dataFile, *output);
+}
+
+void SixDegrees::reload_function(const string &dataFile, ostream &out,
+                                 const StopToken *stop)
 {
-    vector<Artist> neighbors;
-    graph.mark_vertex(curArtist);
-    if (parent.get_name() != "") {
-        graph.set_predecessor(curArtist, parent);
+    ifstream in(dataFile);
+    if (not in.is_open()) {
+        out << "\"" << dataFile << "\" could not be opened." << endl;
+        return;
+    }
+    vector<unique_ptr<Artist>> artists;
+    readArtists(in, artists);
+    if (stop != nullptr and stop->cancelled()) {
+        out << StopToken::MESSAGE << flush;
+        return;
+    }
+
+    /* the graphs copy what they need, so 'artists' can go after */
+    vector<Artist *> rawList;
+    for (unique_ptr<Artist> &artist : artists) {
+        rawList.push_back(artist.get());
+    }
+    try {
+        populateGraph(rawList);
+    } catch (const runtime_error &error) {
+        out << "\"" << dataFile << "\" could not be loaded: "
+            << error.what() << endl;
+        return;
     }
-    if (curArtist == to) {
-        print_path(from, to);
-        pathFound = true;
+    out << "Reloaded " << rawList.size() << " artists from \""
+        << dataFile << "\"." << endl;
+}
+
+/*
+ * @function: within_function
+ * @purpose: Lists every artist within a given number of degrees of
+ * an artist, together with their distance.
+ *
+ * @preconditions: The graph is initialized and contains vertices
+ * representing artists.
+ *
+ * @postconditions: Each artist reached is printed as soon as it is
+ * discovered, in breadth-first order. The search stops at depth
+ * 'degrees', or early once the visitation budget is spent.
+ *
+ * @parameters: from - The starting artist (const Artist&),
+ * degrees - The largest distance to report (size_t).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::within_function(const Artist &from, size_t degrees)
+{
+    within_function(from, degrees, *output);
+}
+
+/*
+ * @function: within_function
+ * @purpose: Lists every artist within a given number of degrees of
+ * an artist, together with their distance.
+ *
+ * @preconditions: The graph is initialized and contains vertices
+ * representing artists.
+ *
+ * @postconditions: Each artist reached is printed to 'out' as soon as
+ * it is discovered, in breadth-first order. The search stops at depth
+ * 'degrees', or early once the visitation budget is spent.
+ *
+ * @parameters: from - The starting artist (const Artist&),
+ * degrees - The largest distance to report (size_t), out - Where the
+ * artists are printed (ostream&), stop - Ends the search early, or
+ * nullptr (const StopToken*).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::within_function(const Artist &from, size_t degrees,
+                                 ostream &out, const StopToken *stop)
+{
+    SnapshotPtr snap = snapshot();
+    VertexId source = resolve(*snap, from, out);
+    if (source == CompactGraph::NO_VERTEX) {
         return;
     }
 
-    neighbors = graph.get_vertex_neighbors(curArtist);
-    for (size_t i = 0; i < neighbors.size(); i++) {
-        if (!graph.is_marked(neighbors[i])) {
-            if (!pathFound) {
-                dfs_private(neighbors[i], curArtist, from, to);
+    /* the visit budget is enforced below, artist by artist */
+    SearchBudget limits = budget;
+    limits.maxVisits = 0;
+    WorkspacePool::Lease ws = workspaces.acquire(snap->graph->vertex_count());
+    ws->watch(stop, limits);
+    bool cutOff = false;
+
+    ws->visit(source, CompactGraph::NO_VERTEX, 0);
+    ws->frontier.push_back(source);
+
+    pmr::vector<uint32_t> expanded(&ws->arena);
+    if (snap->graph->is_bipartite()) {
+        expanded.assign((snap->graph->song_count() + 31) / 32, 0);
+    }
+
+    for (size_t head = 0; head < ws->frontier.size() and not cutOff; head++) {
+        if (ws->interrupted()) {
+            break;
+        }
+        VertexId cur = ws->frontier[head];
+        uint32_t depth = ws->depth(cur);
+        if (depth >= degrees or ws->too_deep(depth)) {
+            continue;
+        }
+
+        /* the unvisited neighbors of 'cur', in adjacency order, go on
+         * the end of the frontier; any the budget cuts off are dropped */
+        size_t tail = ws->frontier.size();
+        size_t found = snap->graph->is_bipartite()
+                     ? append_credited(*snap->graph, cur, *ws, expanded.data())
+                     : append_unvisited(*snap->graph, cur, *ws);
+        for (size_t i = tail; i < tail + found; i++) {
+            VertexId n = ws->frontier[i];
+            if (budget.maxVisits != 0 and
+                ws->visit_count() >= budget.maxVisits) {
+                cutOff = true;
+                ws->frontier.resize(i);
+                break;
             }
+            ws->visit(n, cur, depth + 1);
+
+            out << "\"" << snap->graph->vertex_name(n) << "\" is "
+                << depth + 1 << (depth == 0 ? " degree" : " degrees")
+                << " from \"" << snap->graph->vertex_name(source) << "\"."
+                << "\n";
         }
     }
-}
\ No newline at end of file
+
+    if (cutOff or ws->stop_reason() == StopReason::BUDGET) {
+        out << "Stopped after visiting " << ws->visit_count()
+            << " artists." << "\n";
+    } else if (ws->stop_reason() == StopReason::CANCELLED) {
+        out << StopToken::MESSAGE;
+    }
+    out << "***" << endl;
+}
+
+/*
+ * @function: exclude
+ * @purpose: Marks an artist as excluded from 
+ * the graph traversal.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: The provided artist is 
+ * marked as excluded from further traversal.
+ *
+ * @parameters: exclude - The artist to be 
+ * excluded (const Artist&).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::exclude(const Artist &exclude)
+{
+    graph.mark_vertex(exclude);
+}
+
+/*
+ * @function: configureOutput
+ * @purpose: Configures the output stream 
+ * for printing messages.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: The 'output' stream is 
+ * configured to the provided 'out' stream.
+ *
+ * @parameters: out - Pointer to the output 
+ * stream (ostream*).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::configureOutput(ostream *out)
+{
+    output = out;
+}
+
+/*
+ * @function: configureBudget
+ * @purpose: Sets the limits that bound how much of the graph, 
+ * how long a path and how much time a single search may use.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: Later searches stop once a limit in 'limits'
+ * is reached; a path query that stops without a path prints 
+ * "No path within budget" and is counted as a budget hit by 
+ * --metrics.
+ *
+ * @parameters: limits - The new limits (const SearchBudget&).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::configureBudget(const SearchBudget &limits)
+{
+    budget = limits;
+}
+
+/*
+ * @function: configureOrder
+ * @purpose: Chooses how artists are numbered in the packed copy of
+ * the graph that searches run over.
+ *
+ * @preconditions: Called before populateGraph.
+ *
+ * @postconditions: populateGraph renumbers the artists in 'order'.
+ * Search results do not depend on the order, only memory locality.
+ *
+ * @parameters: order - The numbering to use (VertexOrder).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::configureOrder(VertexOrder order)
+{
+    vertexOrder = order;
+}
+
+/*
+ * @function: configureCompression
+ * @purpose: Chooses whether the packed copy of the graph stores its
+ * adjacency lists delta and varint encoded.
+ *
+ * @preconditions: Called before populateGraph.
+ *
+ * @postconditions: populateGraph compresses the adjacency lists iff
+ * 'compress' is true. Search results are the same either way.
+ *
+ * @parameters: compress - Whether to compress (bool).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::configureCompression(bool compress)
+{
+    compressAdjacency = compress;
+}
+
+/*
+ * @function: configureBipartite
+ * @purpose: Chooses whether the packed copy of the graph stores who is
+ * credited on each song instead of every pair of collaborators.
+ *
+ * @preconditions: Called before populateGraph.
+ *
+ * @postconditions: populateGraph builds a bipartite graph iff
+ * 'bipartite' is true and the dataset allows it (see
+ * CompactGraph::bipartite); the vertex order and compression are then
+ * not applied. Search results are the same either way.
+ *
+ * @parameters: bipartite - Whether to store song credits (bool).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::configureBipartite(bool bipartite)
+{
+    songCredits = bipartite;
+}
+
+/*
+ * @function: profileLoad
+ * @purpose: Fills in the parts of a load profile that populateGraph
+ * measured.
+ *
+ * @preconditions: populateGraph has been called, and is not running
+ * on another thread.
+ *
+ * @postconditions: The graph phase times, counts, memory sizes and
+ * version in 'profile' are set; the parse figures are left alone.
+ *
+ * @parameters: profile - The profile to fill in (LoadProfile&).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::profileLoad(LoadProfile &profile) const
+{
+    lock_guard<mutex> guard(loading);
+    SnapshotPtr snap = snapshot();
+    profile.version      = snap->version;
+    profile.artists      = snap->graph->vertex_count();
+    profile.edges        = snap->graph->edge_count();
+    profile.credits      = snap->graph->credit_count();
+    profile.insertMs     = loadTimes.insertMs;
+    profile.edgeMs       = loadTimes.edgeMs;
+    profile.packMs       = loadTimes.packMs;
+    profile.indexMs      = loadTimes.indexMs;
+    profile.collabBytes  = graph.memory_usage();
+    profile.compactBytes = snap->graph->arena_bytes();
+    profile.creditBytes  = snap->credits->arena_bytes();
+}
+
+/*
+ * @function: snapshot
+ * @purpose: Pins the latest published version of the graph.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: The version stays alive at least as long as the
+ * returned pointer, even if a newer one is published meanwhile.
+ *
+ * @parameters: None.
+ *
+ * @returns: The latest version (SnapshotPtr).
+ */
+
+SnapshotPtr SixDegrees::snapshot() const
+{
+    return atomic_load(&published);
+}
+
+/*
+ * @function: publish
+ * @purpose: Makes a new version of the graph the one queries start on.
+ *
+ * @preconditions: 'snapshot' is complete; nothing changes it after
+ * this.
+ *
+ * @postconditions: Queries that start from now on search 'snapshot'.
+ * The version it replaces is freed once no running query holds it.
+ *
+ * @parameters: snapshot - The new version (SnapshotPtr).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::publish(SnapshotPtr snapshot)
+{
+    atomic_store(&published, std::move(snapshot));
+}
+
+/*
+ * @function: configureMetrics
+ * @purpose: Turns per-query instrumentation on or off.
+ *
+ * @preconditions: 'recorder' outlives its use by this object.
+ *
+ * @postconditions: bfs, dfs and not queries are measured and reported
+ * to 'recorder', or not measured at all if it is nullptr.
+ *
+ * @parameters: recorder - Where measurements go (QueryMetrics*).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::configureMetrics(QueryMetrics *recorder)
+{
+    metrics = recorder;
+}
+
+/*
+ * @function: configureThreads
+ * @purpose: Sets how many threads populateGraph may use.
+ *
+ * @preconditions: Called before populateGraph.
+ *
+ * @postconditions: Edges are built on 'count' threads, or on one per
+ * core if 'count' is zero. The graph does not depend on the count.
+ *
+ * @parameters: count - The number of threads (size_t).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::configureThreads(size_t count)
+{
+    threads = count == 0 ? default_threads() : count;
+}
+
+/*
+ * @function: configureLookup
+ * @purpose: Chooses how forgiving artist lookups are.
+ *
+ * @preconditions: Called before populateGraph.
+ *
+ * @postconditions: If 'foldNames' is set, a name that matches no 
+ * artist exactly matches one that differs only in case and accents. 
+ * If 'suggestions' is not zero, a missing artist is followed by up 
+ * to that many similar names. Either builds a NameMatcher when the 
+ * graph is populated.
+ *
+ * @parameters: foldNames - Whether to ignore case and accents 
+ * (bool), suggestions - How many names to suggest (size_t).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::configureLookup(bool foldNames, size_t suggestions)
+{
+    this->foldNames = foldNames;
+    this->suggestions = suggestions;
+}
+
+/*
+ * @function: configureShards
+ * @purpose: Sends bfs and not queries to worker processes instead of
+ * searching a graph held here.
+ *
+ * @preconditions: 'coordinator' outlives its use by this object.
+ *
+ * @postconditions: bfs and not search the shards 'coordinator' runs,
+ * and the other commands are not available, if it is not nullptr.
+ *
+ * @parameters: coordinator - The shards (ShardCoordinator*).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::configureShards(ShardCoordinator *coordinator)
+{
+    shards = coordinator;
+}
+
+bool SixDegrees::sharded() const
+{
+    return shards != nullptr;
+}
+
+/*
+ * @function: metrics_clock
+ * @purpose: Reads the clock for query timing, but only when metrics
+ * are being recorded.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: The current time, or the epoch when metrics are off
+ * (Clock::time_point).
+ */
+
+SixDegrees::Clock::time_point SixDegrees::metrics_clock() const
+{
+    if (metrics == nullptr) {
+        return Clock::time_point();
+    }
+    return Clock::now();
+}
+
+/*
+ * @function: record_query
+ * @purpose: Completes a query's measurements from its workspace and
+ * hands them to the metrics recorder.
+ *
+ * @preconditions: The query's search and printing are done; 'start'
+ * and 'searched' came from metrics_clock().
+ *
+ * @postconditions: Nothing happens when metrics are off.
+ *
+ * @parameters: snap - The version of the graph the query
+ * pinned (const GraphSnapshot&), query - The measurements so far
+ * (QueryRecord&), ws - The query's search state
+ * (TraversalWorkspace&), from, to - The query's artists
+ * (VertexId), excluded - Artists marked before the search began
+ * (size_t), start, searched - When the search began and ended
+ * (Clock::time_point).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::record_query(const GraphSnapshot &snap, QueryRecord &query,
+                              TraversalWorkspace &ws,
+                              VertexId from, VertexId to, size_t excluded,
+                              Clock::time_point start,
+                              Clock::time_point searched)
+{
+    if (metrics == nullptr or
+        ws.stop_reason() == StopReason::CANCELLED) {
+        return;
+    }
+    Clock::time_point printed = Clock::now();
+
+    query.from         = snap.graph->vertex_name(from);
+    query.to           = snap.graph->vertex_name(to);
+    query.visited      = ws.visit_count() - excluded;
+    query.edgesScanned = ws.edges_scanned();
+    query.frontierPeak = ws.frontier_peak();
+    query.budgetHit    = not query.found and
+                         ws.stop_reason() == StopReason::BUDGET;
+    query.searchMicros =
+        chrono::duration<double, micro>(searched - start).count();
+    query.printMicros  =
+        chrono::duration<double, micro>(printed - searched).count();
+    metrics->record(query);
+}
+
+/*
+ * @function: print_path
+ * @purpose: Prints the path a search over the packed 
+ * graph found between two artists.
+ *
+ * @preconditions: 'ws' holds the predecessors set 
+ * by shortest_path or depth_first_path(ws, from, to).
+ *
+ * @postconditions: None.
+ *
+ * @parameters: snap - The version of the graph the query
+ * pinned (const GraphSnapshot&), ws - The search state 
+ * (TraversalWorkspace&), from - The starting artist 
+ * (VertexId), to - The target artist (VertexId), 
+ * found - Whether the search reached 'to' (bool), 
+ * out - Where the path is printed (ostream&), songs - 
+ * The songs the search was kept to, or nullptr 
+ * (const SongFilter*); each collaboration is then 
+ * printed with the song that let the search take it.
+ *
+ * @returns: The number of collaborations printed (size_t).
+ */
+
+size_t SixDegrees::print_path(const GraphSnapshot &snap,
+                              TraversalWorkspace &ws, VertexId from, 
+                              VertexId to, bool found, ostream &out,
+                              const SongFilter *songs)
+{
+    if (not found) {
+        out << "A path does not exist between "
+            << "\"" << snap.graph->vertex_name(from) << "\"" << " and "
+            << "\"" << snap.graph->vertex_name(to) << "\"." << endl;
+        return 0;
+    }
+
+    ws.scratch.clear();
+    for (VertexId cur = to; cur != from; cur = ws.predecessor(cur)) {
+        ws.scratch.push_back(cur);
+    }
+    ws.scratch.push_back(from);
+
+    for (size_t i = ws.scratch.size() - 1; i > 0; i--) {
+        VertexId a = ws.scratch[i];
+        VertexId b = ws.scratch[i - 1];
+
+        string_view song = songs == nullptr ?
+            snap.graph->song_name(snap.graph->edge_song(a, b)) :
+            songs->credits->song_name(
+                songs->credits->shared_song(a, b, songs->allowed));
+
+        out << "\"" << snap.graph->vertex_name(a) << "\""
+            << " collaborated with "
+            << "\"" << snap.graph->vertex_name(b) << "\"" << " in "
+            << "\"" << song << "\"." << endl;
+    }
+    out << "***" <<endl;
+    return ws.scratch.size() - 1;
+}
+
+/*
+ * @function: shortest_path
+ * @purpose: Breadth-first search over the packed 
+ * graph, expanding each artist with the SIMD 
+ * frontier kernel; BreadthFirst::search (see 
+ * SearchCore.h) specialized for the query.
+ *
+ * @preconditions: 'ws' was reset for the packed 
+ * graph; artists to avoid are already visited.
+ *
+ * @postconditions: Every artist reached has its 
+ * predecessor and depth set in 'ws'. If 'songs' is 
+ * given, only artists who share one of its allowed 
+ * songs are followed to. A bipartite graph is searched 
+ * through its songs, each expanded once. The search gives 
+ * up once ws.interrupted() says so.
+ *
+ * @parameters: snap - The version of the graph the query
+ * pinned (const GraphSnapshot&), ws - The search state 
+ * (TraversalWorkspace&), from - The starting artist 
+ * (VertexId), to - The target artist (VertexId), 
+ * songs - The allowed songs, or nullptr to follow 
+ * every collaboration (const SongFilter*).
+ *
+ * @returns: True iff a path from 'from' to 'to' 
+ * exists. As with report_path, an artist has no 
+ * path to itself.
+ */
+
+bool SixDegrees::shortest_path(const GraphSnapshot &snap,
+                               TraversalWorkspace &ws, VertexId from, 
+                               VertexId to, const SongFilter *songs)
+{
+    if (from == to) {
+        return false;
+    }
+    return traverse<BreadthFirst>(*snap.graph, ws, &from, &from + 1,
+                                  songs, StopAt { to }) == to;
+}
+
+/*
+ * @function: nearest_target
+ * @purpose: Breadth-first search from several artists at 
+ * once, stopping at the first of several targets.
+ *
+ * @preconditions: 'ws' was reset for the packed graph; 
+ * 'targets' is sorted.
+ *
+ * @postconditions: Every source is visited at depth 0, 
+ * in the order given, and every artist reached has its 
+ * predecessor and depth set in 'ws', so the predecessors 
+ * of the target found lead back to its closest source. The 
+ * search gives up once ws.interrupted() says so.
+ *
+ * @parameters: snap - The version of the graph the query
+ * pinned (const GraphSnapshot&), ws - The search state 
+ * (TraversalWorkspace&), sources - The starting artists 
+ * (const pmr::vector<VertexId>&), targets - The artists 
+ * to look for (const pmr::vector<VertexId>&).
+ *
+ * @returns: The first target reached, or NO_VERTEX if 
+ * none is reachable from a source. Sources are never 
+ * reached, even if they are also targets.
+ */
+
+SixDegrees::VertexId
+SixDegrees::nearest_target(const GraphSnapshot &snap, TraversalWorkspace &ws,
+                           const pmr::vector<VertexId> &sources,
+                           const pmr::vector<VertexId> &targets)
+{
+    return traverse<BreadthFirst>(*snap.graph, ws, sources.data(),
+                                  sources.data() + sources.size(), nullptr,
+                                  StopAtAny { &targets });
+}
+
+/*
+ * @function: song_path
+ * @purpose: Breadth-first search restricted by song: the 
+ * songs a query names become a bitmap over the song 
+ * credits' ids, and the frontier kernel follows an artist's 
+ * collaborators only on the songs it allows.
+ *
+ * @preconditions: The graph is initialized.
+ *
+ * @postconditions: The shortest path whose every 
+ * collaboration is on one of 'songs' (if 'through') or on 
+ * none of them (if not) is printed, as bfs prints paths. 
+ * Two artists who share several songs collaborated on 
+ * each, so a collaboration is printed with the first 
+ * allowed song the two share, in the discography of 
+ * whichever comes first in the dataset; with every 
+ * song allowed that is the song bfs prints. Songs no 
+ * collaboration is on are reported, and the 
+ * search is not run, as with missing artists.
+ *
+ * @parameters: snap - The version of the graph the query
+ * pinned (const GraphSnapshot&), command - The query's name, 
+ * for metrics (const char*), from - The starting artist (const Artist&), 
+ * to - The target artist (const Artist&), songs - The songs 
+ * (const vector<string>&), through - Whether the path must 
+ * use (true) or avoid (false) them (bool), out - Where the 
+ * result is printed (ostream&), stop - Ends the search early, 
+ * or nullptr (const StopToken*).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::song_path(const GraphSnapshot &snap, const char *command,
+                           const Artist &from,
+                           const Artist &to, const vector<string> &songs,
+                           bool through, ostream &out,
+                           const StopToken *stop)
+{
+    VertexId source, dest;
+    bool returnValue = validate_from_to(snap, from, to, source, dest, out);
+    bool validateValue = true;
+    for (const string &song : songs) {
+        if (snap.credits->find_song(song) == CompactGraph::NO_SONG) {
+            out << "\"" << song << "\""
+                << " is not a collaboration in the dataset :(" << endl;
+            validateValue = false;
+        }
+    }
+
+    if (!returnValue or !validateValue) {
+        return;
+    }
+
+    WorkspacePool::Lease ws = workspaces.acquire(snap.graph->vertex_count());
+    ws->watch(stop, budget);
+
+    /* lives in the workspace arena, so warmed-up queries do not
+     * allocate */
+    pmr::vector<uint32_t> allowed((snap.credits->song_count() + 31) / 32,
+                                  through ? 0u : ~0u, &ws->arena);
+    pmr::vector<uint32_t> marked((snap.graph->vertex_count() + 31) / 32, 0u,
+                                 &ws->arena);
+    for (const string &song : songs) {
+        CompactGraph::SongId s = snap.credits->find_song(song);
+        if (through) {
+            allowed[s >> 5] |= 1u << (s & 31);
+        } else {
+            allowed[s >> 5] &= ~(1u << (s & 31));
+        }
+    }
+
+    QueryRecord query;
+    query.command = command;
+    Clock::time_point start = metrics_clock();
+    SongFilter filter { snap.credits.get(), allowed.data(), marked.data() };
+    query.found = shortest_path(snap, *ws, source, dest, &filter);
+    Clock::time_point searched = metrics_clock();
+    if (not query.found and report_stop(snap, *ws, source, dest, out)) {
+        record_query(snap, query, *ws, source, dest, 0, start, searched);
+        return;
+    }
+    query.pathLength = print_path(snap, *ws, source, dest, query.found, out,
+                                  &filter);
+    record_query(snap, query, *ws, source, dest, 0, start, searched);
+}
+
+/*
+ * @function: report_stop
+ * @purpose: Prints why a path search ended without a path, if 
+ * it was stopped rather than running out of artists.
+ *
+ * @preconditions: The search found no path.
+ *
+ * @postconditions: A cancelled search prints StopToken::MESSAGE; 
+ * one that ran out of budget (see SearchBudget) prints "No path 
+ * within budget" between the two artists, or between the sources 
+ * and the targets if 'from' is NO_VERTEX.
+ *
+ * @parameters: snap - The version of the graph the query
+ * pinned (const GraphSnapshot&), ws - The search state 
+ * (const TraversalWorkspace&), from, to - The artists searched
+ * between (VertexId), out - Where the message goes (ostream&).
+ *
+ * @returns: True iff the search was stopped.
+ */
+
+bool SixDegrees::report_stop(const GraphSnapshot &snap,
+                             const TraversalWorkspace &ws, VertexId from,
+                             VertexId to, ostream &out) const
+{
+    if (ws.stop_reason() == StopReason::NONE) {
+        return false;
+    }
+    if (ws.stop_reason() == StopReason::CANCELLED) {
+        out << StopToken::MESSAGE << flush;
+    } else if (from == CompactGraph::NO_VERTEX) {
+        out << "No path within budget between the sources and the "
+            << "targets." << endl;
+    } else {
+        out << "No path within budget between \"" 
+            << snap.graph->vertex_name(from) << "\" and \"" 
+            << snap.graph->vertex_name(to) << "\"." << endl;
+    }
+    return true;
+}
+
+/*
+ * @function: find_artist
+ * @purpose: Looks up an artist's id by name, ignoring case 
+ * and accents if configureLookup asked for that.
+ *
+ * @preconditions: populateGraph has been called.
+ *
+ * @postconditions: None. An exact match is always 
+ * preferred; the packed graph's name index turns most 
+ * unknown names away with its Bloom filter.
+ *
+ * @parameters: snap - The version of the graph the query
+ * pinned (const GraphSnapshot&), name - The artist's name (string_view).
+ *
+ * @returns: The artist's id, or NO_VERTEX (VertexId).
+ */
+
+SixDegrees::VertexId SixDegrees::find_artist(const GraphSnapshot &snap,
+                                             string_view name) const
+{
+    VertexId id = snap.graph->find_vertex(name);
+    /* the empty version published before loading has no matcher */
+    if (id == CompactGraph::NO_VERTEX and foldNames and
+        snap.matcher != nullptr) {
+        id = snap.matcher->find_folded(name);
+    }
+    return id;
+}
+
+/*
+ * @function: resolve
+ * @purpose: Looks up the artist named in a query, reporting 
+ * it if it is missing.
+ *
+ * @preconditions: populateGraph has been called.
+ *
+ * @postconditions: If the artist is not found, the "was 
+ * not found" message is printed, followed, when suggestions 
+ * are on, by the closest names in the dataset.
+ *
+ * @parameters: snap - The version of the graph the query
+ * pinned (const GraphSnapshot&), artist - The artist (const Artist&), 
+ * out - Where a missing artist is reported (ostream&).
+ *
+ * @returns: The artist's id, or NO_VERTEX (VertexId).
+ */
+
+SixDegrees::VertexId SixDegrees::resolve(const GraphSnapshot &snap,
+                                         const Artist &artist,
+                                         ostream &out) const
+{
+    VertexId id = find_artist(snap, artist.get_name());
+    if (id != CompactGraph::NO_VERTEX) {
+        return id;
+    }
+
+    out << "\"" << artist.get_name() << "\"" 
+    << " was not found in the dataset :(" << endl;
+
+    if (suggestions > 0 and snap.matcher != nullptr) {
+        vector<VertexId> matches;
+        snap.matcher->suggest(artist.get_name(), suggestions, matches);
+        for (size_t i = 0; i < matches.size(); i++) {
+            out << (i == 0 ? "Did you mean " :
+                    i + 1 == matches.size() ? " or " : ", ")
+                << "\"" << snap.graph->vertex_name(matches[i]) << "\"";
+        }
+        if (not matches.empty()) {
+            out << "?" << endl;
+        }
+    }
+    return id;
+}
+
+/*
+ * @function: validate_from_to
+ * @purpose: Validates if both 'from' and 'to' 
+ * artists exist in the graph dataset.
+ *
+ * @preconditions: The graph is initialized and 
+ * contains vertices representing artists.
+ *
+ * @postconditions: 'source' and 'dest' are the ids of 
+ * 'from' and 'to', or NO_VERTEX for an artist that is 
+ * missing. Names are resolved (and missing ones 
+ * reported) as resolve() does.
+ *
+ * @parameters: snap - The version of the graph the query
+ * pinned (const GraphSnapshot&), from - The starting artist 
+ * (const Artist&), to - The target artist (const Artist&),
+ * source, dest - Set to their ids (VertexId&), 
+ * out - Where missing artists are reported (ostream&).
+ *
+ * @returns: True if both 'from' and 'to' 
+ * artists exist in the graph dataset, false otherwise.
+ */
+
+bool SixDegrees::validate_from_to(const GraphSnapshot &snap,
+                                  const Artist &from, const Artist &to,
+                                  VertexId &source, VertexId &dest,
+                                                        ostream &out) {
+
+    bool returnValue = true;
+    source = resolve(snap, from, out);
+    if (source == CompactGraph::NO_VERTEX) {
+        returnValue = false;
+    }
+
+    dest = resolve(snap, to, out);
+    if (dest == CompactGraph::NO_VERTEX) {
+        returnValue = false;
+    }
+    return returnValue;
+}
+
+/*
+ * @function: validateList
+ * @purpose: Validates if all artists in the 
+ * provided list exist in the graph dataset.
+ *
+ * @preconditions: The graph is initialized and 
+ * contains vertices representing artists.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: snap - The version of the graph the query
+ * pinned (const GraphSnapshot&), List - The list of artists to 
+ * validate (const vector<Artist>&), out - Where missing 
+ * artists are reported (ostream&).
+ *
+ * @returns: True if all artists in the list 
+ * exist in the graph dataset, false otherwise.
+ */
+
+bool SixDegrees::validateList(const GraphSnapshot &snap,
+                              const vector<Artist> &List, ostream &out)
+{
+    bool validateValue = true;
+    for (size_t i = 0; i < List.size(); i++) {
+        if (validateExclude(snap, List[i], out) == false) {
+            validateValue = false;
+        }
+    }
+    return validateValue;
+}
+
+/*
+ * @function: validateExclude
+ * @purpose: Validates if the provided artist 
+ * exists in the graph dataset.
+ *
+ * @preconditions: The graph is initialized and 
+ * contains vertices representing artists.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: snap - The version of the graph the query
+ * pinned (const GraphSnapshot&), exclude - The artist to validate 
+ * (const Artist&), out - Where a missing artist is 
+ * reported (ostream&).
+ *
+ * @returns: True if the provided artist exists 
+ * in the graph dataset, false otherwise.
+ */
+
+bool SixDegrees::validateExclude(const GraphSnapshot &snap,
+                                 const Artist &exclude, ostream &out)
+{
+    return resolve(snap, exclude, out) != CompactGraph::NO_VERTEX;
+}
+
+/*
+ * @function: depth_first_path
+ * @purpose: Depth-first search over the packed graph, 
+ * run by DepthFirst::search (see SearchCore.h). 
+ * It visits artists in the same order as a recursive 
+ * search would, but keeps its stack in the workspace's 
+ * scratch arena and the neighbors still to try on its 
+ * frontier. Neighbors already visited when an artist is 
+ * entered are never tried, so the frontier kernel drops 
+ * them up front.
+ *
+ * @preconditions: 'ws' was reset for the packed graph.
+ *
+ * @postconditions: Every artist entered has its 
+ * predecessor set in 'ws'; the search stops as soon 
+ * as it enters 'to', or gives up once ws.interrupted() 
+ * says so.
+ *
+ * @parameters: snap - The version of the graph the query
+ * pinned (const GraphSnapshot&), ws - The search state 
+ * (TraversalWorkspace&), from - The starting artist 
+ * (VertexId), to - The target artist (VertexId).
+ *
+ * @returns: True iff a path from 'from' to 'to' 
+ * exists. An artist has no path to itself.
+ */
+
+bool SixDegrees::depth_first_path(const GraphSnapshot &snap,
+                                  TraversalWorkspace &ws, VertexId from,
+                                                            VertexId to)
+{
+    if (from == to) {
+        return false;
+    }
+    return traverse<DepthFirst>(*snap.graph, ws, &from, &from + 1, nullptr,
+                                StopAt { to }) == to;
+}
+
+/*
+ * @function: sharded_path
+ * @purpose: The bfs and not queries, searched across the shards.
+ *
+ * @preconditions: configureShards was given a coordinator.
+ *
+ * @postconditions: Prints to 'out' what bfs_function or not_function
+ * would for the same graph: missing artists, the path, or that there
+ * is none.
+ *
+ * @parameters: from - The starting artist (const Artist&), to - The
+ * target artist (const Artist&), notList - Artists to avoid (const
+ * vector<Artist>&), out - Where the result goes (ostream&), stop -
+ * Ends the search early, or nullptr (const StopToken*).
+ *
+ * @returns: None.
+ */
+
+void SixDegrees::sharded_path(const Artist &from, const Artist &to,
+                              const vector<Artist> &notList, ostream &out,
+                              const StopToken *stop)
+{
+    VertexId source = find_shard_artist(from, out);
+    VertexId dest = find_shard_artist(to, out);
+    bool valid = source != ShardCoordinator::NO_VERTEX and
+                 dest != ShardCoordinator::NO_VERTEX;
+    vector<VertexId> excluded;
+    for (const Artist &artist : notList) {
+        VertexId id = find_shard_artist(artist, out);
+        valid = valid and id != ShardCoordinator::NO_VERTEX;
+        excluded.push_back(id);
+    }
+    if (not valid) {
+        return;
+    }
+
+    vector<VertexId> path;
+    vector<ShardCoordinator::SongId> songs;
+    if (not shards->shortest_path(source, dest, excluded, path, songs,
+                                  stop)) {
+        if (stop != nullptr and stop->cancelled()) {
+            out << StopToken::MESSAGE << flush;
+            return;
+        }
+        out << "A path does not exist between "
+            << "\"" << shards->vertex_name(source) << "\"" << " and "
+            << "\"" << shards->vertex_name(dest) << "\"." << endl;
+        return;
+    }
+    for (size_t i = 0; i < songs.size(); i++) {
+        out << "\"" << shards->vertex_name(path[i]) << "\""
+            << " collaborated with "
+            << "\"" << shards->vertex_name(path[i + 1]) << "\"" << " in "
+            << "\"" << shards->song_name(songs[i]) << "\"." << endl;
+    }
+    out << "***" <<endl;
+}
+
+/*
+ * @function: find_shard_artist
+ * @purpose: Looks an artist up in the shards' names.
+ *
+ * @preconditions: configureShards was given a coordinator.
+ *
+ * @postconditions: A missing artist is reported to 'out' as resolve
+ * reports it, without suggestions.
+ *
+ * @parameters: artist - The artist (const Artist&), out - Where a
+ * missing artist is reported (ostream&).
+ *
+ * @returns: The artist's id, or NO_VERTEX (VertexId).
+ */
+
+SixDegrees::VertexId SixDegrees::find_shard_artist(const Artist &artist,
+                                                   ostream &out) const
+{
+    VertexId id = shards->find_vertex(artist.get_name());
+    if (id == ShardCoordinator::NO_VERTEX) {
+        out << "\"" << artist.get_name() << "\"" 
+        << " was not found in the dataset :(" << endl;
+    }
+    return id;
+}
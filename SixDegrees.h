@@ -8,22 +8,35 @@
 #ifndef __SIX_DEGREES__
 #define __SIX_DEGREES__
 
+#include <chrono>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <stack>
+#include <string>
 #include <vector>
 #include <unordered_map>
 
 #include "Artist.h"
 #include "CollabGraph.h"
+#include "CompactGraph.h"
+#include "GraphSnapshot.h"
+#include "NameMatcher.h"
+#include "ShardedSearch.h"
+#include "Traversal.h"
+#include "QueryMetrics.h"
+#include "DataLoader.h"
 
 using namespace std;
 
+struct SongFilter;
+
 class SixDegrees {
     public:
 
         SixDegrees();
 
-        void populateGraph(vector<Artist *> artistList);
+        size_t populateGraph(vector<Artist *> artistList);
         void setEdges(vector<Artist *> artistList);
 
         void print();
@@ -34,24 +47,147 @@ class SixDegrees {
         void bfs_function(const Artist &from, const Artist &to);
         void dfs_function(const Artist &from, const Artist &to);
         void not_function(const Artist &from, const Artist &to, 
-                                                vector<Artist> notList);
+                                          const vector<Artist> &notList);
+        void within_function(const Artist &from, size_t degrees);
+
+        /* the same queries, printing to 'out' instead of 'output'; any
+         * number may run at once, each with its own stream, and each
+         * stops early if its 'stop' token says so */
+        void bfs_function(const Artist &from, const Artist &to,
+                          ostream &out, const StopToken *stop = nullptr);
+        void dfs_function(const Artist &from, const Artist &to,
+                          ostream &out, const StopToken *stop = nullptr);
+        void not_function(const Artist &from, const Artist &to,
+                          const vector<Artist> &notList, ostream &out,
+                          const StopToken *stop = nullptr);
+        void within_function(const Artist &from, size_t degrees,
+                             ostream &out, const StopToken *stop = nullptr);
+
+        /* shortest paths using only, or none of, the named songs */
+        void through_function(const Artist &from, const Artist &to,
+                              const vector<string> &songs);
+        void through_function(const Artist &from, const Artist &to,
+                              const vector<string> &songs, ostream &out,
+                              const StopToken *stop = nullptr);
+        void avoid_function(const Artist &from, const Artist &to,
+                            const vector<string> &songs);
+        void avoid_function(const Artist &from, const Artist &to,
+                            const vector<string> &songs, ostream &out,
+                            const StopToken *stop = nullptr);
+
+        /* the shortest path from any of 'sources' to any of 'targets' */
+        void mbfs_function(const vector<Artist> &sources,
+                           const vector<Artist> &targets);
+        void mbfs_function(const vector<Artist> &sources,
+                           const vector<Artist> &targets, ostream &out,
+                           const StopToken *stop = nullptr);
+
+        /* the distances between every pair of artists listed in a file */
+        void matrix_function(const string &listFile,
+                             const string &matrixFile);
+        void matrix_function(const string &listFile,
+                             const string &matrixFile, ostream &out,
+                             const StopToken *stop = nullptr);
+
+        /* the whole graph in the columnar format of ColumnarExport.h */
+        void export_function(const string &file);
+        void export_function(const string &file, ostream &out,
+                             const StopToken *stop = nullptr);
+
+        /* the whole graph as text, as print writes it */
+        void dump_function(const string &file);
+        void dump_function(const string &file, ostream &out);
+
+        /* a new graph from another dataFile, swapped in once built */
+        void reload_function(const string &dataFile);
+        void reload_function(const string &dataFile, ostream &out,
+                             const StopToken *stop = nullptr);
 
         void exclude(const Artist &exclude);
         
 
         void configureOutput(ostream *out);
+        void configureBudget(const SearchBudget &limits);
+        void configureOrder(VertexOrder order);
+        void configureCompression(bool compress);
+        void configureBipartite(bool bipartite);
+        void configureMetrics(QueryMetrics *recorder);
+        void configureThreads(size_t count);
+        void configureLookup(bool foldNames, size_t suggestions);
+        void configureShards(ShardCoordinator *coordinator);
+        bool sharded() const;
+        void profileLoad(LoadProfile &profile) const;
+
+        /* the latest published version of the graph; queries already
+         * running keep searching the one they started with */
+        SnapshotPtr snapshot() const;
         ostream *output;
         
     private:
         CollabGraph graph;
-        bool pathFound = false;
-
-        void print_path(const Artist &from, const Artist &to);
-        bool validate_from_to(const Artist &from, const Artist &to);
-        bool validateList(vector<Artist> List);
-        bool validateExclude(const Artist &exclude);
-        void dfs_private(const Artist &curArtist, const Artist &parent,
-                                       const Artist &from, const Artist &to);
+        SnapshotPtr published;     /* read and swapped atomically */
+        WorkspacePool workspaces;
+        SearchBudget budget;
+        VertexOrder vertexOrder = VertexOrder::INSERTION;
+        bool compressAdjacency = false;
+        bool songCredits = false;
+        QueryMetrics *metrics = nullptr;
+        size_t threads;
+        LoadProfile loadTimes;
+        mutable mutex loading;     /* one build at a time */
+        bool foldNames = false;
+        ShardCoordinator *shards = nullptr;
+        size_t suggestions = 0;
+
+        typedef CompactGraph::VertexId VertexId;
+        typedef std::chrono::steady_clock Clock;
+
+        void publish(SnapshotPtr snapshot);
+
+        /* every helper below works on the version its query pinned */
+        size_t print_path(const GraphSnapshot &snap, TraversalWorkspace &ws,
+                          VertexId from, VertexId to, bool found,
+                          ostream &out, const SongFilter *songs = nullptr);
+        bool report_stop(const GraphSnapshot &snap,
+                         const TraversalWorkspace &ws, VertexId from,
+                         VertexId to, ostream &out) const;
+        VertexId find_artist(const GraphSnapshot &snap,
+                             string_view name) const;
+        VertexId resolve(const GraphSnapshot &snap, const Artist &artist,
+                         ostream &out) const;
+        Clock::time_point metrics_clock() const;
+        void record_query(const GraphSnapshot &snap, QueryRecord &query,
+                          TraversalWorkspace &ws,
+                          VertexId from, VertexId to, size_t excluded,
+                          Clock::time_point start,
+                          Clock::time_point searched);
+        bool shortest_path(const GraphSnapshot &snap, TraversalWorkspace &ws,
+                           VertexId from, VertexId to,
+                           const SongFilter *songs = nullptr);
+        VertexId nearest_target(const GraphSnapshot &snap,
+                                TraversalWorkspace &ws,
+                                const pmr::vector<VertexId> &sources,
+                                const pmr::vector<VertexId> &targets);
+        void song_path(const GraphSnapshot &snap, const char *command,
+                       const Artist &from,
+                       const Artist &to, const vector<string> &songs,
+                       bool through, ostream &out,
+                       const StopToken *stop);
+        bool validate_from_to(const GraphSnapshot &snap,
+                              const Artist &from, const Artist &to,
+                              VertexId &source, VertexId &dest,
+                                                        ostream &out);
+        bool depth_first_path(const GraphSnapshot &snap,
+                              TraversalWorkspace &ws, VertexId from,
+                                                            VertexId to);
+        bool validateList(const GraphSnapshot &snap,
+                          const vector<Artist> &List, ostream &out);
+        bool validateExclude(const GraphSnapshot &snap,
+                             const Artist &exclude, ostream &out);
+        void sharded_path(const Artist &from, const Artist &to,
+                          const vector<Artist> &notList, ostream &out,
+                          const StopToken *stop);
+        VertexId find_shard_artist(const Artist &artist, ostream &out) const;
 };
 
 #endif /* __SIX_DEGREES__ */
\ No newline at end of file
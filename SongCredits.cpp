@@ -0,0 +1,305 @@
+/*
+ * SongCredits.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Build and query the song credits of a snapshot.
+ */
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "SongCredits.h"
+
+using namespace std;
+
+/*
+ * @constructor: SongCredits
+ * @purpose: Records who is credited on every song two or more artists
+ * share.
+ *
+ * @preconditions: 'graph' was built from 'artistList'.
+ *
+ * @postconditions: Every title at least two artists list is a song,
+ * numbered as first seen; a title an artist lists twice is credited
+ * to it once, and blank titles are ignored. Artists are the ids
+ * 'graph' gives their names; if two artists share a name, the first
+ * one's songs are kept.
+ *
+ * @parameters: graph - The snapshot's graph (const CompactGraph&),
+ * artistList - The dataset (const vector<Artist*>&).
+ *
+ * @returns: None.
+ */
+
+SongCredits::SongCredits(const CompactGraph &graph,
+                         const vector<Artist *> &artistList)
+    : titles(&arena), titleIndex(&arena), position(&arena),
+      songOffsets(&arena), songs(&arena), artistOffsets(&arena),
+      artists(&arena)
+{
+    const uint32_t UNPLACED = UINT32_MAX;
+    size_t vertexCount = graph.vertex_count();
+    position.assign(vertexCount, UNPLACED);
+
+    /* the vertex of each artist, or NO_VERTEX to skip it */
+    vector<VertexId> vertexOf(artistList.size(),
+                              VertexId(CompactGraph::NO_VERTEX));
+    for (size_t i = 0; i < artistList.size(); i++) {
+        VertexId v = graph.find_vertex(artistList[i]->get_name());
+        if (v != CompactGraph::NO_VERTEX and position[v] == UNPLACED) {
+            position[v] = i;
+            vertexOf[i] = v;
+        }
+    }
+
+    /* every distinct title and how many artists list it */
+    size_t listed = 0;
+    for (size_t i = 0; i < artistList.size(); i++) {
+        listed += artistList[i]->get_discography().size();
+    }
+    unordered_map<string_view, uint32_t> titleIds;
+    titleIds.reserve(listed);
+    vector<string_view> seen;
+    vector<uint32_t>    artistCount;
+    vector<size_t>      lastArtist;
+    for (size_t i = 0; i < artistList.size(); i++) {
+        if (vertexOf[i] == CompactGraph::NO_VERTEX) {
+            continue;
+        }
+        for (const string &song : artistList[i]->get_discography()) {
+            if (song.empty()) {
+                continue;
+            }
+            auto title = titleIds.emplace(song, seen.size()).first;
+            if (title->second == seen.size()) {
+                seen.push_back(song);
+                artistCount.push_back(0);
+                lastArtist.push_back(SIZE_MAX);
+            }
+            if (lastArtist[title->second] != i) {
+                lastArtist[title->second] = i;
+                artistCount[title->second]++;
+            }
+        }
+    }
+
+    /* only shared titles become songs */
+    vector<SongId> songOf(seen.size(), SongId(CompactGraph::NO_SONG));
+    artistOffsets.push_back(0);
+    for (size_t t = 0; t < seen.size(); t++) {
+        if (artistCount[t] > 1) {
+            songOf[t] = titles.size();
+            titles.push_back(arena.copy_string(seen[t]));
+            artistOffsets.push_back(artistOffsets.back() + artistCount[t]);
+        }
+    }
+    titleIndex.build(titles);
+
+    /* the artists of each song, and every credit in dataset order */
+    vector<pair<VertexId, SongId>> credits;
+    credits.reserve(artistOffsets.back());
+    vector<size_t> cursor(artistOffsets.begin(), artistOffsets.end() - 1);
+    artists.resize(artistOffsets.back());
+    fill(lastArtist.begin(), lastArtist.end(), SIZE_MAX);
+    for (size_t i = 0; i < artistList.size(); i++) {
+        VertexId v = vertexOf[i];
+        if (v == CompactGraph::NO_VERTEX) {
+            continue;
+        }
+        for (const string &song : artistList[i]->get_discography()) {
+            auto title = titleIds.find(song);
+            if (title == titleIds.end() or
+                songOf[title->second] == CompactGraph::NO_SONG or
+                lastArtist[title->second] == i) {
+                continue;
+            }
+            lastArtist[title->second] = i;
+            SongId s = songOf[title->second];
+            credits.emplace_back(v, s);
+            artists[cursor[s]++] = v;
+        }
+    }
+
+    /* ids follow the graph's order, which need not be the dataset's */
+    for (SongId s = 0; s < titles.size(); s++) {
+        sort(artists.begin() + artistOffsets[s],
+             artists.begin() + artistOffsets[s + 1]);
+    }
+
+    /* each artist's songs, grouped by artist in discography order */
+    songOffsets.assign(vertexCount + 1, 0);
+    for (const pair<VertexId, SongId> &credit : credits) {
+        songOffsets[credit.first + 1]++;
+    }
+    for (VertexId v = 0; v < vertexCount; v++) {
+        songOffsets[v + 1] += songOffsets[v];
+    }
+    cursor.assign(songOffsets.begin(), songOffsets.end() - 1);
+    songs.resize(credits.size());
+    for (const pair<VertexId, SongId> &credit : credits) {
+        songs[cursor[credit.first]++] = credit.second;
+    }
+}
+
+/*
+ * @function: song_count
+ * @purpose: Reports the number of shared songs.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: One more than the largest song id (size_t).
+ */
+
+size_t SongCredits::song_count() const
+{
+    return titles.size();
+}
+
+/*
+ * @function: find_song
+ * @purpose: Looks up a shared song by title.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: title - The song's title (string_view).
+ *
+ * @returns: The song's id, or NO_SONG if fewer than two artists list
+ * it (SongId).
+ */
+
+SongCredits::SongId SongCredits::find_song(string_view title) const
+{
+    return titleIndex.find(title);
+}
+
+/*
+ * @function: song_name
+ * @purpose: Gives the title of a shared song.
+ *
+ * @preconditions: 's' is less than song_count().
+ *
+ * @postconditions: None.
+ *
+ * @parameters: s - A song id (SongId).
+ *
+ * @returns: The title (string_view).
+ */
+
+string_view SongCredits::song_name(SongId s) const
+{
+    return titles[s];
+}
+
+/*
+ * @function: songs_begin / songs_end
+ * @purpose: Delimit the shared songs of an artist.
+ *
+ * @preconditions: 'v' is a vertex of the graph the credits were built
+ * for.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: v - An artist id (VertexId).
+ *
+ * @returns: Pointers to the first and one-past-last song of 'v', in
+ * discography order (const SongId*).
+ */
+
+const SongCredits::SongId *SongCredits::songs_begin(VertexId v) const
+{
+    return songs.data() + songOffsets[v];
+}
+
+const SongCredits::SongId *SongCredits::songs_end(VertexId v) const
+{
+    return songs.data() + songOffsets[v + 1];
+}
+
+/*
+ * @function: artists_begin / artists_end
+ * @purpose: Delimit the artists credited on a song.
+ *
+ * @preconditions: 's' is less than song_count().
+ *
+ * @postconditions: None.
+ *
+ * @parameters: s - A song id (SongId).
+ *
+ * @returns: Pointers to the first and one-past-last artist of 's', in
+ * ascending order (const VertexId*).
+ */
+
+const SongCredits::VertexId *SongCredits::artists_begin(SongId s) const
+{
+    return artists.data() + artistOffsets[s];
+}
+
+const SongCredits::VertexId *SongCredits::artists_end(SongId s) const
+{
+    return artists.data() + artistOffsets[s + 1];
+}
+
+/*
+ * @function: shared_song
+ * @purpose: Names the song a filtered collaboration is on.
+ *
+ * @preconditions: 'a' and 'b' are vertices of the graph the credits
+ * were built for.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: a, b - Two artists (VertexId), allowed - A bitmap over
+ * song ids, or nullptr to allow every song (const uint32_t*).
+ *
+ * @returns: The first allowed song, in the discography of whichever
+ * of the two comes first in the dataset, that the other is also on;
+ * NO_SONG if there is none (SongId). With every song allowed, this is
+ * the song the graph gives the collaboration.
+ */
+
+SongCredits::SongId SongCredits::shared_song(VertexId a, VertexId b,
+                                             const uint32_t *allowed) const
+{
+    VertexId first  = position[a] < position[b] ? a : b;
+    VertexId second = first == a ? b : a;
+    for (const SongId *s = songs_begin(first); s != songs_end(first); s++) {
+        if (allowed != nullptr and
+            not ((allowed[*s >> 5] >> (*s & 31)) & 1)) {
+            continue;
+        }
+        if (binary_search(artists_begin(*s), artists_end(*s), second)) {
+            return *s;
+        }
+    }
+    return CompactGraph::NO_SONG;
+}
+
+/*
+ * @function: arena_bytes
+ * @purpose: Reports the memory held by the credits' arena: titles,
+ * index and credit arrays.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: The bytes reserved by the arena (size_t).
+ */
+
+size_t SongCredits::arena_bytes() const
+{
+    return arena.bytes_reserved();
+}
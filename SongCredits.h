@@ -0,0 +1,84 @@
+/*
+ * SongCredits.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Who is credited on each song, for the song-filtered searches
+ *   (through and avoid). The packed graph keeps one song per
+ *   collaboration, the first one the two artists share, but two
+ *   artists may share several: a path through a song may take any
+ *   collaboration on it, and a path that avoids songs may take any
+ *   collaboration with another shared song left. So every snapshot
+ *   also keeps each title credited to two or more artists, with its
+ *   artists, and each artist's shared titles in discography order,
+ *   in the ids of the snapshot's graph.
+ *
+ *   Like the graph's, the credits' arrays and titles live in their own
+ *   arena.
+ */
+#ifndef __SONG_CREDITS__
+#define __SONG_CREDITS__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+#include "Arena.h"
+#include "Artist.h"
+#include "CompactGraph.h"
+#include "NameIndex.h"
+
+class SongCredits {
+    public:
+        typedef CompactGraph::VertexId VertexId;
+        typedef CompactGraph::SongId   SongId;
+
+        SongCredits(const CompactGraph &graph,
+                    const std::vector<Artist *> &artistList);
+
+        /* the credits' data lives in their arena, so it is never
+         * copied */
+        SongCredits(const SongCredits &) = delete;
+        SongCredits &operator=(const SongCredits &) = delete;
+
+        size_t           song_count() const;
+        SongId           find_song(std::string_view title) const;
+        std::string_view song_name(SongId s) const;
+
+        /* the shared songs of v, in discography order */
+        const SongId   *songs_begin(VertexId v) const;
+        const SongId   *songs_end(VertexId v) const;
+
+        /* the artists of s, ascending */
+        const VertexId *artists_begin(SongId s) const;
+        const VertexId *artists_end(SongId s) const;
+
+        SongId shared_song(VertexId a, VertexId b,
+                           const uint32_t *allowed) const;
+
+        size_t arena_bytes() const;
+
+    private:
+        /* declared first so it outlives every container below */
+        Arena arena;
+
+        std::pmr::vector<std::string_view> titles;
+        NameIndex titleIndex;
+
+        /* where each artist is in the dataset, which decides whose
+         * discography names the song of a collaboration */
+        std::pmr::vector<uint32_t> position;
+
+        /* the songs of v are songs[songOffsets[v] .. songOffsets[v + 1])
+         * and the artists of s are artists[artistOffsets[s] ..
+         * artistOffsets[s + 1]) */
+        std::pmr::vector<size_t>   songOffsets;
+        std::pmr::vector<SongId>   songs;
+        std::pmr::vector<size_t>   artistOffsets;
+        std::pmr::vector<VertexId> artists;
+};
+
+#endif /* __SONG_CREDITS__ */
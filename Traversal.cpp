@@ -0,0 +1,227 @@
+/*
+ * Traversal.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Reusable search workspaces and the pool that lends them out.
+ */
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Traversal.h"
+
+using namespace std;
+
+/*
+ * @constructor: TraversalWorkspace
+ * @purpose: Constructs an empty workspace.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: The workspace must be reset() before use.
+ *
+ * @parameters: None.
+ *
+ * @returns: None.
+ */
+
+TraversalWorkspace::TraversalWorkspace()
+{
+    visits       = 0;
+    edgesScanned = 0;
+    frontierPeak = 0;
+    watch(nullptr, SearchBudget());
+}
+
+/*
+ * @function: reset
+ * @purpose: Prepares the workspace for a new search.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: No vertex is visited, the frontier and scratch
+ * arena are empty and the arrays cover at least 'vertexCount'
+ * vertices. Memory is only
+ * allocated the first time a larger graph is seen.
+ *
+ * @parameters: vertexCount - The number of vertices in the graph
+ * about to be searched (size_t).
+ *
+ * @returns: None.
+ */
+
+void TraversalWorkspace::reset(size_t vertexCount)
+{
+    if (dirtyWords.size() > visitedBits.size() / 8) {
+        fill(visitedBits.begin(), visitedBits.end(), 0);
+    } else {
+        for (uint32_t word : dirtyWords) {
+            visitedBits[word] = 0;
+        }
+    }
+    dirtyWords.clear();
+
+    if (predecessors.size() < vertexCount) {
+        visitedBits.resize((vertexCount + 31) / 32, 0);
+        predecessors.resize(vertexCount);
+        depths.resize(vertexCount);
+    }
+
+    visits       = 0;
+    edgesScanned = 0;
+    frontierPeak = 0;
+    watch(nullptr, SearchBudget());
+    frontier.clear();
+    arena.reset();
+}
+
+/*
+ * @function: watch
+ * @purpose: Sets what may stop the search about to run.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: interrupted() and too_deep() enforce 'budget', and
+ * interrupted() also answers to 'token' if there is one. The deadline,
+ * if any, is 'budget.deadlineMs' from now, and only visits made from
+ * now on count against 'budget.maxVisits'.
+ *
+ * @parameters: token - Cancels the search, or nullptr (const
+ * StopToken*), budget - Its limits (const SearchBudget&).
+ *
+ * @returns: None.
+ */
+
+void TraversalWorkspace::watch(const StopToken *token,
+                               const SearchBudget &budget)
+{
+    stop        = token;
+    maxVisits   = budget.maxVisits;
+    watchedFrom = visits;
+    maxDepth    = budget.maxDepth;
+    hasDeadline = budget.deadlineMs != 0;
+    if (hasDeadline) {
+        deadline = Clock::now() + chrono::milliseconds(budget.deadlineMs);
+    }
+    polled      = stop != nullptr or hasDeadline;
+    sinceCheck  = 0;
+    depthCut    = false;
+    stopReason  = StopReason::NONE;
+}
+
+/*
+ * @function: poll
+ * @purpose: The slow half of interrupted(): asks the token and the
+ * clock whether to stop.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: The stop reason is CANCELLED if the token was
+ * cancelled, or BUDGET if the deadline has passed.
+ *
+ * @parameters: None.
+ *
+ * @returns: True iff the search should stop.
+ */
+
+bool TraversalWorkspace::poll()
+{
+    if (stop != nullptr and stop->cancelled()) {
+        stopReason = StopReason::CANCELLED;
+    } else if (hasDeadline and Clock::now() >= deadline) {
+        stopReason = StopReason::BUDGET;
+    }
+    return stopReason != StopReason::NONE;
+}
+
+/*
+ * @function: acquire
+ * @purpose: Lends out a workspace that has been reset for a graph of
+ * the given size.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: The workspace returns to the pool when the lease
+ * is destroyed.
+ *
+ * @parameters: vertexCount - The number of vertices in the graph
+ * about to be searched (size_t).
+ *
+ * @returns: A lease on a workspace (Lease).
+ */
+
+WorkspacePool::Lease WorkspacePool::acquire(size_t vertexCount)
+{
+    unique_ptr<TraversalWorkspace> workspace;
+    {
+        lock_guard<mutex> guard(lock);
+        if (not idle.empty()) {
+            workspace = std::move(idle.back());
+            idle.pop_back();
+        }
+    }
+
+    if (workspace == nullptr) {
+        workspace = make_unique<TraversalWorkspace>();
+    }
+    workspace->reset(vertexCount);
+    return Lease(this, std::move(workspace));
+}
+
+/*
+ * @function: release
+ * @purpose: Returns a workspace to the pool.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: The workspace can be lent out again.
+ *
+ * @parameters: workspace - The workspace being returned
+ * (unique_ptr<TraversalWorkspace>).
+ *
+ * @returns: None.
+ */
+
+void WorkspacePool::release(unique_ptr<TraversalWorkspace> workspace)
+{
+    lock_guard<mutex> guard(lock);
+    idle.push_back(std::move(workspace));
+}
+
+/*
+ * @function: Lease constructors and destructor
+ * @purpose: Track ownership of a borrowed workspace.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: Exactly one lease returns the workspace to 'pool'.
+ *
+ * @parameters: pool - The lending pool (WorkspacePool*), workspace -
+ * The borrowed workspace (unique_ptr<TraversalWorkspace>).
+ *
+ * @returns: None.
+ */
+
+WorkspacePool::Lease::Lease(WorkspacePool *pool,
+                            unique_ptr<TraversalWorkspace> workspace)
+    : pool(pool), workspace(std::move(workspace))
+{
+
+}
+
+WorkspacePool::Lease::Lease(Lease &&source)
+    : pool(source.pool), workspace(std::move(source.workspace))
+{
+
+}
+
+WorkspacePool::Lease::~Lease()
+{
+    if (workspace != nullptr) {
+        pool->release(std::move(workspace));
+    }
+}
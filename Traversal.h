@@ -0,0 +1,210 @@
+/*
+ * Traversal.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Scratch state for searches over a CompactGraph. A workspace holds
+ *   the visited marks, predecessors, depths and frontier of one search.
+ *   Visited marks live in a bitmap (one bit per artist, dense enough for
+ *   the SIMD kernels in FrontierKernel.h), and a new search only clears
+ *   the words the previous search set, not a pass over every vertex.
+ *   Workspaces are handed out by a pool so the arrays are allocated once
+ *   and reused by every query. Anything else a search needs for one
+ *   query comes out of the workspace's scratch arena.
+ */
+#ifndef __TRAVERSAL__
+#define __TRAVERSAL__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "CompactGraph.h"
+#include "Arena.h"
+
+/*
+ * Limits on how much one search may spend: artists visited, the
+ * length of the paths it follows, and wall-clock time from when it
+ * starts. Zero means unlimited.
+ */
+struct SearchBudget {
+    size_t maxVisits  = 0;
+    size_t maxDepth   = 0;
+    size_t deadlineMs = 0;
+};
+
+/*
+ * Stops one query from outside it: cancel() may be called from any
+ * thread while the query runs. Searches poll the token through their
+ * workspace (see interrupted()), so a cancelled search ends within a
+ * few thousand artists of the request.
+ */
+class StopToken {
+    public:
+        void cancel() { stop.store(true, std::memory_order_relaxed); }
+        bool cancelled() const
+        {
+            return stop.load(std::memory_order_relaxed);
+        }
+
+        /* what a cancelled query prints instead of its result */
+        static constexpr const char *MESSAGE = "The search was cancelled.\n";
+
+    private:
+        std::atomic<bool> stop { false };
+};
+
+/* why a search ended before it was done */
+enum class StopReason { NONE, CANCELLED, BUDGET };
+
+class TraversalWorkspace {
+    public:
+        typedef CompactGraph::VertexId VertexId;
+
+        TraversalWorkspace();
+
+        void reset(size_t vertexCount);
+
+        bool is_visited(VertexId v) const
+        {
+            return (visitedBits[v >> 5] >> (v & 31)) & 1;
+        }
+
+        void visit(VertexId v, VertexId pred, uint32_t depth)
+        {
+            uint32_t &word = visitedBits[v >> 5];
+            if (word == 0) {
+                dirtyWords.push_back(v >> 5);
+            }
+            word |= 1u << (v & 31);
+            predecessors[v] = pred;
+            depths[v]       = depth;
+            visits++;
+        }
+
+        VertexId predecessor(VertexId v) const { return predecessors[v]; }
+        uint32_t depth(VertexId v) const       { return depths[v]; }
+        size_t   visit_count() const           { return visits; }
+        const uint32_t *visited_bits() const   { return visitedBits.data(); }
+
+        /* work counters reported by --metrics; a few adds per vertex */
+        void count_edges(size_t n)  { edgesScanned += n; }
+        void note_frontier(size_t n)
+        {
+            if (n > frontierPeak) {
+                frontierPeak = n;
+            }
+        }
+        size_t edges_scanned() const { return edgesScanned; }
+        size_t frontier_peak() const { return frontierPeak; }
+
+        /* the token and budget the current search answers to; the
+         * deadline and the visit budget start now, so artists marked
+         * before are not counted, and reset() forgets both */
+        void watch(const StopToken *token, const SearchBudget &budget);
+
+        /* called once per artist a search expands; checks the visit
+         * budget every time, the token and the clock every
+         * CHECK_INTERVAL calls, and stays true once it said stop */
+        bool interrupted()
+        {
+            if (stopReason != StopReason::NONE) {
+                return true;
+            }
+            if (maxVisits != 0 and visits - watchedFrom >= maxVisits) {
+                stopReason = StopReason::BUDGET;
+                return true;
+            }
+            if (not polled or ++sinceCheck < CHECK_INTERVAL) {
+                return false;
+            }
+            sinceCheck = 0;
+            return poll();
+        }
+
+        /* whether an artist 'depth' collaborations out may not be
+         * expanded; a search that is refused ran out of budget unless
+         * it finds its path anyway */
+        bool too_deep(size_t depth)
+        {
+            if (maxDepth == 0 or depth < maxDepth) {
+                return false;
+            }
+            depthCut = true;
+            return true;
+        }
+
+        StopReason stop_reason() const
+        {
+            return stopReason != StopReason::NONE ? stopReason
+                 : depthCut ? StopReason::BUDGET : StopReason::NONE;
+        }
+
+        /* frontier storage; reset() empties it but keeps its capacity */
+        std::vector<VertexId> frontier;
+
+        /* holds a decoded adjacency list when the graph is compressed */
+        std::vector<VertexId> scratch;
+
+        /* per-query scratch memory; reset() empties it but keeps its
+         * chunks, so a warmed-up search allocates nothing */
+        Arena arena;
+
+    private:
+        static const uint32_t CHECK_INTERVAL = 4096;
+        typedef std::chrono::steady_clock Clock;
+
+        bool poll();
+
+        size_t visits;
+        size_t edgesScanned;
+        size_t frontierPeak;
+
+        const StopToken *stop;
+        size_t maxVisits;
+        size_t watchedFrom;         /* visits before watch() */
+        size_t maxDepth;
+        bool polled;                /* a token or a deadline to check */
+        bool hasDeadline;
+        Clock::time_point deadline;
+        uint32_t sinceCheck;
+        bool depthCut;
+        StopReason stopReason;
+        std::vector<uint32_t> visitedBits;
+        std::vector<uint32_t> dirtyWords;
+        std::vector<VertexId> predecessors;
+        std::vector<uint32_t> depths;
+};
+
+class WorkspacePool {
+    public:
+        /* hands a workspace back to its pool when it goes out of scope */
+        class Lease {
+            public:
+                Lease(WorkspacePool *pool,
+                      std::unique_ptr<TraversalWorkspace> workspace);
+                Lease(Lease &&source);
+                ~Lease();
+
+                TraversalWorkspace &operator*()  { return *workspace; }
+                TraversalWorkspace *operator->() { return workspace.get(); }
+
+            private:
+                WorkspacePool *pool;
+                std::unique_ptr<TraversalWorkspace> workspace;
+        };
+
+        Lease acquire(size_t vertexCount);
+
+    private:
+        void release(std::unique_ptr<TraversalWorkspace> workspace);
+
+        std::mutex lock;
+        std::vector<std::unique_ptr<TraversalWorkspace>> idle;
+};
+
+#endif /* __TRAVERSAL__ */
@@ -0,0 +1,222 @@
+/*
+ * BenchUtil.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Helpers shared by the benchmarks in bench/.
+ */
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "BenchUtil.h"
+
+using namespace std;
+
+/*
+ * @constructor: CacheMissCounter
+ * @purpose: Opens a perf counter for last-level cache misses of the
+ * calling thread.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: If perf_event_open is not permitted the counter is
+ * unavailable and stop() reports zero.
+ *
+ * @parameters: None.
+ *
+ * @returns: None.
+ */
+
+CacheMissCounter::CacheMissCounter()
+{
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.config         = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+CacheMissCounter::~CacheMissCounter()
+{
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+/*
+ * @function: available / start / stop
+ * @purpose: Query, start and read the counter.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: stop() disables the counter.
+ *
+ * @parameters: None.
+ *
+ * @returns: available() - True iff misses can be counted (bool);
+ * stop() - The misses since start() (long long).
+ */
+
+bool CacheMissCounter::available() const
+{
+    return fd >= 0;
+}
+
+void CacheMissCounter::start()
+{
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+long long CacheMissCounter::stop()
+{
+    long long count = 0;
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &count, sizeof(count)) != sizeof(count)) {
+            count = 0;
+        }
+    }
+    return count;
+}
+
+/*
+ * @function: buildGraph
+ * @purpose: Builds the collaboration graph from a song index, which is
+ * much faster than SixDegrees::setEdges on large datasets. Edge songs
+ * may differ from setEdges when two artists share several songs, which
+ * does not matter for timing.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: 'graph' holds every artist and collaboration.
+ *
+ * @parameters: artists - The parsed dataFile
+ * (const vector<unique_ptr<Artist>>&), graph - The graph to fill
+ * (CollabGraph&).
+ *
+ * @returns: None.
+ */
+
+void buildGraph(const vector<unique_ptr<Artist>> &artists, CollabGraph &graph)
+{
+    unordered_map<string, vector<const Artist *>> bySong;
+    for (const unique_ptr<Artist> &artist : artists) {
+        graph.insert_vertex(*artist);
+        for (const string &song : artist->get_discography()) {
+            bySong[song].push_back(artist.get());
+        }
+    }
+
+    for (auto &entry : bySong) {
+        const vector<const Artist *> &credited = entry.second;
+        for (size_t i = 0; i < credited.size(); i++) {
+            for (size_t j = i + 1; j < credited.size(); j++) {
+                if (*credited[i] != *credited[j]) {
+                    graph.insert_edge(*credited[i], *credited[j],
+                                      entry.first);
+                }
+            }
+        }
+    }
+}
+
+/*
+ * @function: timeSearches
+ * @purpose: Runs one full breadth-first search from each source.
+ *
+ * @preconditions: Every name in 'sources' is in 'graph'.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: graph - The graph to search (const CompactGraph&),
+ * sources - The artists to start from (const vector<string>&),
+ * pool - Supplies the workspace (WorkspacePool&), misses - Set to the
+ * cache misses counted, or -1 if they cannot be counted (long long&).
+ *
+ * @returns: The total search time in milliseconds (double).
+ */
+
+double timeSearches(const CompactGraph &graph, const vector<string> &sources,
+                    WorkspacePool &pool, long long &misses)
+{
+    typedef CompactGraph::VertexId VertexId;
+    WorkspacePool::Lease ws = pool.acquire(graph.vertex_count());
+    CacheMissCounter counter;
+    size_t reached = 0;
+
+    counter.start();
+    auto start = chrono::steady_clock::now();
+    for (const string &name : sources) {
+        ws->reset(graph.vertex_count());
+        VertexId source = graph.find_vertex(name);
+        ws->visit(source, CompactGraph::NO_VERTEX, 0);
+        ws->frontier.push_back(source);
+        for (size_t head = 0; head < ws->frontier.size(); head++) {
+            VertexId cur = ws->frontier[head];
+            graph.for_each_neighbor_id(cur, [&](VertexId n) {
+                if (not ws->is_visited(n)) {
+                    ws->visit(n, cur, ws->depth(cur) + 1);
+                    ws->frontier.push_back(n);
+                }
+                return true;
+            });
+        }
+        reached += ws->frontier.size();
+    }
+    auto stop = chrono::steady_clock::now();
+    misses = counter.available() ? counter.stop() : -1;
+
+    if (reached == 0) {
+        cerr << "no artists reached" << endl;
+    }
+    return chrono::duration<double, milli>(stop - start).count();
+}
+
+/*
+ * @function: parseCount
+ * @purpose: Reads a non-negative whole number from the command line.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: 'count' is set iff the text is a number.
+ *
+ * @parameters: text - The text to read (const string&), count - Set
+ * to the number read (size_t&).
+ *
+ * @returns: True iff 'text' is made up only of digits, and at most 18
+ * of them.
+ */
+
+bool parseCount(const string &text, size_t &count)
+{
+    if (text.empty() or text.size() > 18) {
+        return false;
+    }
+    size_t value = 0;
+    for (char c : text) {
+        if (c < '0' or c > '9') {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+    }
+    count = value;
+    return true;
+}
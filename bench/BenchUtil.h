@@ -0,0 +1,72 @@
+/*
+ * BenchUtil.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Helpers shared by the benchmarks in bench/: a hardware cache miss
+ *   counter, a fast graph builder, a timed full-search loop, an
+ *   output stream that throws away what is written to it and a
+ *   checked reader for numeric arguments.
+ */
+#ifndef __BENCH_UTIL__
+#define __BENCH_UTIL__
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "Artist.h"
+#include "CollabGraph.h"
+#include "CompactGraph.h"
+#include "Traversal.h"
+
+/* counts last-level cache misses for this thread, if perf is allowed */
+class CacheMissCounter {
+    public:
+        CacheMissCounter();
+        ~CacheMissCounter();
+
+        bool      available() const;
+        void      start();
+        long long stop();
+
+    private:
+        int fd;
+};
+
+/* formats everything written to it, then discards it */
+class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override
+        {
+            setp(buffer, buffer + sizeof(buffer));
+            return c;
+        }
+
+    private:
+        char buffer[4096];
+};
+
+class NullStream : public std::ostream {
+    public:
+        NullStream() : std::ostream(&sink) {}
+
+    private:
+        NullBuffer sink;
+};
+
+void buildGraph(const std::vector<std::unique_ptr<Artist>> &artists,
+                CollabGraph &graph);
+
+double timeSearches(const CompactGraph &graph,
+                    const std::vector<std::string> &sources,
+                    WorkspacePool &pool, long long &misses);
+
+/* false, leaving 'count' alone, unless 'text' is all digits */
+bool parseCount(const std::string &text, size_t &count);
+
+#endif /* __BENCH_UTIL__ */
@@ -0,0 +1,138 @@
+/*
+ * CompressBench.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Compare plain and varint-compressed adjacency lists. For each
+ *   vertex order the adjacency memory, the time to scan every edge and
+ *   the time of full breadth-first searches are reported for both
+ *   storage modes.
+ *
+ * Usage: ./compress_bench dataFile [searches]
+ *
+ *   `make compress_bench` builds it with optimization, apart from the
+ *   debug objects of SixDegrees.
+ */
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Artist.h"
+#include "CollabGraph.h"
+#include "CompactGraph.h"
+#include "DataLoader.h"
+#include "Traversal.h"
+#include "BenchUtil.h"
+
+using namespace std;
+
+/*
+ * @function: timeScan
+ * @purpose: Visits every edge of the graph a few times.
+ *
+ * @parameters: graph - The graph to scan (const CompactGraph&).
+ *
+ * @returns: The time of one scan in milliseconds (double).
+ */
+
+double timeScan(const CompactGraph &graph)
+{
+    const int rounds = 5;
+    uint64_t checksum = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (CompactGraph::VertexId v = 0; v < graph.vertex_count(); v++) {
+            graph.for_each_neighbor(v, [&](CompactGraph::VertexId n,
+                                           CompactGraph::SongId song) {
+                checksum += n + song;
+                return true;
+            });
+        }
+    }
+    auto stop = chrono::steady_clock::now();
+
+    if (checksum == 1) {
+        cerr << "unlikely checksum" << endl;
+    }
+    return chrono::duration<double, milli>(stop - start).count() / rounds;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t searches = 32;
+    if (argc < 2 || argc > 3 ||
+        (argc == 3 && (not parseCount(argv[2], searches) || searches == 0))) {
+        cerr << "Usage: ./compress_bench dataFile [searches]" << endl;
+        return 1;
+    }
+
+    ifstream dataFile(argv[1]);
+    if (not dataFile.is_open()) {
+        cerr << "Error: could not open file " << argv[1] << endl;
+        return 1;
+    }
+    vector<unique_ptr<Artist>> artists;
+    readArtists(dataFile, artists);
+    CollabGraph collab;
+    buildGraph(artists, collab);
+    CompactGraph base(collab);
+    if (base.vertex_count() == 0) {
+        cerr << "Error: " << argv[1] << " holds no artists" << endl;
+        return 1;
+    }
+
+    vector<string> sources;
+    for (size_t i = 0; i < searches; i++) {
+        size_t pick = (i * 2654435761u) % base.vertex_count();
+        sources.push_back(string(base.vertex_name(pick)));
+    }
+
+    cout << base.vertex_count() << " artists, " << base.edge_count()
+         << " collaborations, " << sources.size() << " full searches\n\n";
+    cout << left << setw(11) << "order" << setw(12) << "storage" << right
+         << setw(14) << "adjacency KB" << setw(10) << "ratio"
+         << setw(10) << "scan ms" << setw(10) << "bfs ms"
+         << setw(10) << "bfs" << "\n";
+
+    WorkspacePool pool;
+    const char *names[] = { "insertion", "rcm" };
+
+    for (const char *name : names) {
+        VertexOrder order;
+        parse_vertex_order(name, order);
+        unique_ptr<CompactGraph> plainCopy = base.relabeled(order);
+        unique_ptr<CompactGraph> packedCopy = plainCopy->compressed();
+        const CompactGraph &plain = *plainCopy;
+        const CompactGraph &packed = *packedCopy;
+
+        long long misses;
+        timeSearches(plain, sources, pool, misses);   /* warm up */
+        double plainTime = timeSearches(plain, sources, pool, misses);
+        timeSearches(packed, sources, pool, misses);
+        double packedTime = timeSearches(packed, sources, pool, misses);
+
+        const CompactGraph *graphs[] = { &plain, &packed };
+        double times[] = { plainTime, packedTime };
+        for (int i = 0; i < 2; i++) {
+            cout << left << setw(11) << name
+                 << setw(12) << (i == 0 ? "plain" : "varint") << right
+                 << fixed << setprecision(2)
+                 << setw(14) << graphs[i]->adjacency_bytes() / 1024.0
+                 << setw(9) << double(plain.adjacency_bytes()) /
+                                graphs[i]->adjacency_bytes() << "x"
+                 << setw(10) << timeScan(*graphs[i])
+                 << setw(10) << times[i]
+                 << setw(9) << 100 * times[i] / plainTime << "%\n";
+        }
+    }
+
+    cout << "\nratio is plain memory / this memory; bfs is relative to "
+         << "plain storage in the same order." << endl;
+    return 0;
+}
@@ -0,0 +1,50 @@
+/*
+ * GenDataset.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Write a synthetic power-law dataFile (see Synthetic.h).
+ *
+ * Usage: ./gen_dataset artists [seed] [outputFile]
+ *
+ *   e.g. ./gen_dataset 10000000 7 artists10m.txt
+ */
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "Synthetic.h"
+
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2 or argc > 4) {
+        cerr << "Usage: ./gen_dataset artists [seed] [outputFile]" << endl;
+        return 1;
+    }
+
+    SyntheticSpec spec;
+    try {
+        spec.artists = stoull(argv[1]);
+        if (argc >= 3) {
+            spec.seed = stoull(argv[2]);
+        }
+    } catch (const exception &) {
+        cerr << "artists and seed must be whole numbers" << endl;
+        return 1;
+    }
+
+    if (argc == 4) {
+        ofstream outputFile(argv[3]);
+        if (not outputFile.is_open()) {
+            cerr << "Error: could not open file " << argv[3] << endl;
+            return 1;
+        }
+        writeSynthetic(outputFile, spec);
+    } else {
+        writeSynthetic(cout, spec);
+    }
+    return 0;
+}
@@ -0,0 +1,251 @@
+/*
+ * KernelBench.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Measure the per-edge cost of a full breadth-first search three
+ *   ways: the original CollabGraph search (is_marked / set_predecessor
+ *   on Artist instances), the packed graph with the scalar frontier
+ *   filter, and the packed graph with the AVX2 filter.
+ *
+ * Usage: ./kernel_bench dataFile [searches]
+ *
+ *   `make kernel_bench` builds it with optimization, and only the AVX2
+ *   filter with -mavx2. SixDegrees does not link the AVX2 filter.
+ */
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "Artist.h"
+#include "CollabGraph.h"
+#include "CompactGraph.h"
+#include "DataLoader.h"
+#include "FrontierKernel.h"
+#include "Traversal.h"
+#include "BenchUtil.h"
+
+using namespace std;
+
+/* the AVX2 filter, in FrontierKernelAvx2.cpp, which only this
+ * benchmark links; only call it when simd_filter_available() */
+extern const bool avx2_filter_built;
+
+size_t filter_unvisited_avx2(const CompactGraph::VertexId *begin,
+                             const CompactGraph::VertexId *end,
+                             const uint32_t *visited,
+                             CompactGraph::VertexId *out);
+
+/*
+ * @function: simd_filter_available
+ * @purpose: Reports whether this build and CPU can run the AVX2 filter.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: None.
+ *
+ * @returns: True iff the AVX2 filter can be used (bool).
+ */
+
+bool simd_filter_available()
+{
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    return avx2_filter_built and __builtin_cpu_supports("avx2") and
+           __builtin_cpu_supports("popcnt");
+#else
+    return false;
+#endif
+}
+
+/*
+ * @function: select_unvisited_filter
+ * @purpose: Picks an implementation of the unvisited-neighbor filter.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: allowSimd - Whether the AVX2 filter may be chosen (bool).
+ *
+ * @returns: The AVX2 filter if allowed and supported, else the scalar
+ * one (UnvisitedFilter).
+ */
+
+UnvisitedFilter select_unvisited_filter(bool allowSimd)
+{
+    if (allowSimd and simd_filter_available()) {
+        return filter_unvisited_avx2;
+    }
+    return filter_unvisited_scalar;
+}
+
+/*
+ * @function: unvisited_filter_name
+ * @purpose: Names a filter for reports.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: filter - A filter from select_unvisited_filter
+ * (UnvisitedFilter).
+ *
+ * @returns: "avx2" or "scalar" (const char*).
+ */
+
+const char *unvisited_filter_name(UnvisitedFilter filter)
+{
+    return filter == filter_unvisited_scalar ? "scalar" : "avx2";
+}
+
+/*
+ * @function: collabSearch
+ * @purpose: Full breadth-first search the way SixDegrees::bfs_function
+ * did it before the packed graph existed.
+ *
+ * @parameters: graph - The graph to search (CollabGraph&), from - The
+ * starting artist (const Artist&), edges - Incremented by the number
+ * of edges scanned (size_t&).
+ *
+ * @returns: None.
+ */
+
+void collabSearch(CollabGraph &graph, const Artist &from, size_t &edges)
+{
+    queue<Artist> q;
+    vector<Artist> neighbors;
+
+    graph.clear_metadata();
+    q.push(from);
+    while (!q.empty()) {
+        Artist curArtist = q.front();
+        q.pop();
+        if (graph.is_marked(curArtist)) {
+            continue;
+        }
+        graph.mark_vertex(curArtist);
+
+        neighbors = graph.get_vertex_neighbors(curArtist);
+        edges += neighbors.size();
+        for (size_t i = 0; i < neighbors.size(); i++) {
+            if (graph.is_marked(neighbors[i]) == false) {
+                graph.set_predecessor(neighbors[i], curArtist);
+                q.push(neighbors[i]);
+            }
+        }
+    }
+}
+
+/*
+ * @function: packedSearch
+ * @purpose: Full breadth-first search over the packed graph using the
+ * given frontier filter.
+ *
+ * @parameters: graph - The graph to search (const CompactGraph&),
+ * ws - The search state (TraversalWorkspace&), from - The starting
+ * artist (VertexId), filter - The frontier filter (UnvisitedFilter),
+ * edges - Incremented by the number of edges scanned (size_t&).
+ *
+ * @returns: None.
+ */
+
+void packedSearch(const CompactGraph &graph, TraversalWorkspace &ws,
+                  CompactGraph::VertexId from, UnvisitedFilter filter,
+                  size_t &edges)
+{
+    ws.reset(graph.vertex_count());
+    ws.visit(from, CompactGraph::NO_VERTEX, 0);
+    ws.frontier.push_back(from);
+    for (size_t head = 0; head < ws.frontier.size(); head++) {
+        CompactGraph::VertexId cur = ws.frontier[head];
+        size_t tail = ws.frontier.size();
+        size_t found = append_unvisited(graph, cur, ws, filter);
+        edges += graph.degree(cur);
+        for (size_t i = tail; i < tail + found; i++) {
+            ws.visit(ws.frontier[i], cur, ws.depth(cur) + 1);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t searches = 8;
+    if (argc < 2 || argc > 3 ||
+        (argc == 3 && (not parseCount(argv[2], searches) || searches == 0))) {
+        cerr << "Usage: ./kernel_bench dataFile [searches]" << endl;
+        return 1;
+    }
+
+    ifstream dataFile(argv[1]);
+    if (not dataFile.is_open()) {
+        cerr << "Error: could not open file " << argv[1] << endl;
+        return 1;
+    }
+    vector<unique_ptr<Artist>> artists;
+    readArtists(dataFile, artists);
+    CollabGraph collab;
+    buildGraph(artists, collab);
+    CompactGraph graph(collab);
+    if (graph.vertex_count() == 0) {
+        cerr << "Error: " << argv[1] << " holds no artists" << endl;
+        return 1;
+    }
+
+    vector<CompactGraph::VertexId> sources;
+    for (size_t i = 0; i < searches; i++) {
+        sources.push_back((i * 2654435761u) % graph.vertex_count());
+    }
+
+    cout << graph.vertex_count() << " artists, " << graph.edge_count()
+         << " collaborations, " << sources.size() << " full searches, "
+         << "AVX2 " << (simd_filter_available() ? "available" : "unavailable")
+         << "\n\n";
+    cout << left << setw(22) << "search" << right << setw(12) << "total ms"
+         << setw(14) << "ns per edge" << setw(10) << "speedup" << "\n";
+
+    double baseline = 0;
+    size_t edges = 0;
+    auto start = chrono::steady_clock::now();
+    for (CompactGraph::VertexId source : sources) {
+        collabSearch(collab, Artist(string(graph.vertex_name(source))), edges);
+    }
+    auto stop = chrono::steady_clock::now();
+    double time = chrono::duration<double, milli>(stop - start).count();
+    baseline = time * 1e6 / edges;
+    cout << left << setw(22) << "CollabGraph (before)" << right << fixed
+         << setprecision(2) << setw(12) << time << setw(14) << baseline
+         << setw(9) << 1.0 << "x\n";
+
+    WorkspacePool pool;
+    WorkspacePool::Lease ws = pool.acquire(graph.vertex_count());
+    bool allow[] = { false, true };
+    for (bool simd : allow) {
+        UnvisitedFilter filter = select_unvisited_filter(simd);
+        if (simd and not simd_filter_available()) {
+            continue;
+        }
+        edges = 0;
+        packedSearch(graph, *ws, sources[0], filter, edges);   /* warm up */
+        edges = 0;
+        start = chrono::steady_clock::now();
+        for (CompactGraph::VertexId source : sources) {
+            packedSearch(graph, *ws, source, filter, edges);
+        }
+        stop = chrono::steady_clock::now();
+        time = chrono::duration<double, milli>(stop - start).count();
+        double perEdge = time * 1e6 / edges;
+        cout << left << setw(22)
+             << string("packed + ") + unvisited_filter_name(filter)
+             << right << setw(12) << time << setw(14) << perEdge
+             << setw(9) << baseline / perEdge << "x\n";
+    }
+    return 0;
+}
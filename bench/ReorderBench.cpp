@@ -0,0 +1,113 @@
+/*
+ * ReorderBench.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Measure how each vertex numbering affects search speed. For every
+ *   order the graph is renumbered and a full breadth-first search is
+ *   run from the same artists; the BFS time, the hardware cache misses
+ *   (when the kernel lets us count them) and the mean id distance
+ *   between collaborators are reported relative to insertion order.
+ *
+ * Usage: ./reorder_bench dataFile [searches]
+ *
+ *   `make reorder_bench` builds it with optimization, apart from the
+ *   debug objects of SixDegrees.
+ */
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Artist.h"
+#include "CollabGraph.h"
+#include "CompactGraph.h"
+#include "DataLoader.h"
+#include "Traversal.h"
+#include "BenchUtil.h"
+
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    size_t searches = 32;
+    if (argc < 2 || argc > 3 ||
+        (argc == 3 && (not parseCount(argv[2], searches) || searches == 0))) {
+        cerr << "Usage: ./reorder_bench dataFile [searches]" << endl;
+        return 1;
+    }
+
+    ifstream dataFile(argv[1]);
+    if (not dataFile.is_open()) {
+        cerr << "Error: could not open file " << argv[1] << endl;
+        return 1;
+    }
+    vector<unique_ptr<Artist>> artists;
+    readArtists(dataFile, artists);
+    CollabGraph collab;
+    buildGraph(artists, collab);
+    CompactGraph base(collab);
+    if (base.vertex_count() == 0) {
+        cerr << "Error: " << argv[1] << " holds no artists" << endl;
+        return 1;
+    }
+
+    vector<string> sources;
+    for (size_t i = 0; i < searches; i++) {
+        size_t pick = (i * 2654435761u) % base.vertex_count();
+        sources.push_back(string(base.vertex_name(pick)));
+    }
+
+    cout << base.vertex_count() << " artists, " << base.edge_count()
+         << " collaborations, " << sources.size() << " full searches\n\n";
+    cout << left << setw(11) << "order" << right << setw(12) << "relabel ms"
+         << setw(12) << "mean gap" << setw(12) << "bfs ms"
+         << setw(10) << "bfs" << setw(14) << "cache misses"
+         << setw(10) << "misses" << "\n";
+
+    WorkspacePool pool;
+    const char *names[] = { "insertion", "bfs", "rcm", "degree" };
+    double baseTime = 0;
+    long long baseMisses = 0;
+
+    for (const char *name : names) {
+        VertexOrder order;
+        parse_vertex_order(name, order);
+
+        auto start = chrono::steady_clock::now();
+        unique_ptr<CompactGraph> copy = base.relabeled(order);
+        const CompactGraph &graph = *copy;
+        auto stop = chrono::steady_clock::now();
+        double relabelTime =
+            chrono::duration<double, milli>(stop - start).count();
+
+        long long misses;
+        timeSearches(graph, sources, pool, misses);   /* warm up */
+        double time = timeSearches(graph, sources, pool, misses);
+        if (order == VertexOrder::INSERTION) {
+            baseTime   = time;
+            baseMisses = misses;
+        }
+
+        cout << left << setw(11) << name << right << fixed
+             << setprecision(2) << setw(12) << relabelTime
+             << setw(12) << graph.mean_neighbor_gap()
+             << setw(12) << time
+             << setw(9) << (baseTime > 0 ? 100 * time / baseTime : 0) << "%";
+        if (misses >= 0) {
+            cout << setw(14) << misses << setw(9)
+                 << (baseMisses > 0 ? 100.0 * misses / baseMisses : 0) << "%";
+        } else {
+            cout << setw(14) << "n/a" << setw(10) << "n/a";
+        }
+        cout << "\n";
+    }
+
+    cout << "\nbfs and misses are relative to insertion order.";
+    cout << " Cache misses need perf_event_open access." << endl;
+    return 0;
+}
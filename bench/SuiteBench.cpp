@@ -0,0 +1,367 @@
+/*
+ * SuiteBench.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Google Benchmark microbenchmarks for loading a dataFile, building
+ *   the graph and answering queries, over synthetic power-law datasets
+ *   (see Synthetic.h) of increasing size.
+ *
+ *     ReadArtists  parsing a dataFile, as main does
+ *     Populate     SixDegrees::populateGraph (parallel edge build)
+ *     SetEdges     SixDegrees::setEdges over an already built graph:
+ *                  every pairwise comparison and duplicate-edge check
+ *     InsertEdge   CollabGraph::insert_edge for every collaboration
+ *     GetEdge      CollabGraph::get_edge between collaborators
+ *     FindVertex   CompactGraph::find_vertex for names in the dataset
+ *                  (Hit) and for unknown names (Miss)
+ *     Bfs/Dfs/Not  SixDegrees queries between random artists
+ *
+ * Usage: ./suite_bench [--max-artists=N] [Google Benchmark flags]
+ *
+ *   Sizes run from 1k artists up to N (default 100k, at most 10M).
+ *   setEdges compares every pair of artists, so it stops at 4k
+ *   artists. `make bench` runs
+ *   the suite and writes the results to bench.json; pass
+ *   --benchmark_format=json to print JSON instead of a table.
+ */
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Artist.h"
+#include "CollabGraph.h"
+#include "CompactGraph.h"
+#include "DataLoader.h"
+#include "SixDegrees.h"
+#include "BenchUtil.h"
+#include "Synthetic.h"
+
+using namespace std;
+
+/* SixDegrees::setEdges is quadratic, so it is only run on small sets */
+static const size_t SET_EDGES_MAX = 4096;
+
+/* how many random queries each query benchmark cycles through */
+static const size_t QUERY_PAIRS = 256;
+
+/*
+ * Generated datasets, shared by every benchmark of the same size so
+ * each is only generated once per run.
+ */
+struct Dataset {
+    string text;
+    vector<unique_ptr<Artist>> artists;
+    vector<Artist *> rawList;
+};
+
+static Dataset &dataset(size_t artists)
+{
+    static map<size_t, unique_ptr<Dataset>> cache;
+    unique_ptr<Dataset> &data = cache[artists];
+    if (data == nullptr) {
+        SyntheticSpec spec;
+        spec.artists = artists;
+
+        data = make_unique<Dataset>();
+        stringstream text;
+        writeSynthetic(text, spec);
+        data->text = text.str();
+        readArtists(text, data->artists);
+        for (unique_ptr<Artist> &artist : data->artists) {
+            data->rawList.push_back(artist.get());
+        }
+    }
+    return *data;
+}
+
+/*
+ * A SixDegrees populated from a dataset, with its output thrown away.
+ */
+struct Populated {
+    NullStream out;
+    SixDegrees sixDegrees;
+};
+
+static SixDegrees &populated(size_t artists)
+{
+    static map<size_t, unique_ptr<Populated>> cache;
+    unique_ptr<Populated> &entry = cache[artists];
+    if (entry == nullptr) {
+        entry = make_unique<Populated>();
+        entry->sixDegrees.configureOutput(&entry->out);
+        entry->sixDegrees.populateGraph(dataset(artists).rawList);
+    }
+    return entry->sixDegrees;
+}
+
+/*
+ * @function: randomPairs
+ * @purpose: Picks random pairs of artists. The same dataset and seed
+ * always give the same pairs.
+ *
+ * @parameters: data - The dataset (Dataset&), count - How many pairs
+ * (size_t), seed - Seeds the choice (uint64_t).
+ *
+ * @returns: Pairs of artists (vector<pair<Artist, Artist>>).
+ */
+
+static vector<pair<Artist, Artist>> randomPairs(Dataset &data, size_t count,
+                                                uint64_t seed)
+{
+    mt19937_64 rng(seed);
+    uniform_int_distribution<size_t> pick(0, data.artists.size() - 1);
+
+    vector<pair<Artist, Artist>> pairs;
+    for (size_t i = 0; i < count; i++) {
+        pairs.emplace_back(*data.artists[pick(rng)], *data.artists[pick(rng)]);
+    }
+    return pairs;
+}
+
+/*
+ * @function: collaborations
+ * @purpose: Lists every collaboration in a dataset once, through a
+ * song index rather than setEdges.
+ *
+ * @parameters: data - The dataset (Dataset&).
+ *
+ * @returns: (artist, artist, song) triples
+ * (vector<pair<pair<Artist *, Artist *>, string>>).
+ */
+
+typedef pair<pair<Artist *, Artist *>, string> Collaboration;
+
+static vector<Collaboration> collaborations(Dataset &data)
+{
+    unordered_map<string, vector<Artist *>> bySong;
+    for (Artist *artist : data.rawList) {
+        for (const string &song : artist->get_discography()) {
+            bySong[song].push_back(artist);
+        }
+    }
+
+    vector<Collaboration> edges;
+    for (auto &entry : bySong) {
+        const vector<Artist *> &credited = entry.second;
+        for (size_t i = 0; i < credited.size(); i++) {
+            for (size_t j = i + 1; j < credited.size(); j++) {
+                edges.push_back(Collaboration(
+                    make_pair(credited[i], credited[j]), entry.first));
+            }
+        }
+    }
+    return edges;
+}
+
+static void BM_ReadArtists(benchmark::State &state)
+{
+    Dataset &data = dataset(state.range(0));
+    for (auto _ : state) {
+        istringstream text(data.text);
+        vector<unique_ptr<Artist>> artists;
+        readArtists(text, artists);
+        benchmark::DoNotOptimize(artists.data());
+    }
+    state.SetBytesProcessed(state.iterations() * data.text.size());
+    state.SetItemsProcessed(state.iterations() * data.artists.size());
+}
+
+static void BM_Populate(benchmark::State &state)
+{
+    Dataset &data = dataset(state.range(0));
+    for (auto _ : state) {
+        SixDegrees sixDegrees;
+        sixDegrees.populateGraph(data.rawList);
+    }
+    state.SetItemsProcessed(state.iterations() * data.artists.size());
+}
+
+static void BM_SetEdges(benchmark::State &state)
+{
+    Dataset &data = dataset(state.range(0));
+    SixDegrees sixDegrees;
+    sixDegrees.populateGraph(data.rawList);
+
+    /* every edge already exists, so this times the comparisons and
+     * insert_edge's duplicate check but not the appends */
+    for (auto _ : state) {
+        sixDegrees.setEdges(data.rawList);
+    }
+    state.SetItemsProcessed(state.iterations() * data.artists.size());
+}
+
+static void BM_InsertEdge(benchmark::State &state)
+{
+    Dataset &data = dataset(state.range(0));
+    vector<Collaboration> edges = collaborations(data);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        unique_ptr<CollabGraph> graph = make_unique<CollabGraph>();
+        for (Artist *artist : data.rawList) {
+            graph->insert_vertex(*artist);
+        }
+        state.ResumeTiming();
+
+        for (const Collaboration &edge : edges) {
+            if (*edge.first.first != *edge.first.second) {
+                graph->insert_edge(*edge.first.first, *edge.first.second,
+                                   edge.second);
+            }
+        }
+
+        state.PauseTiming();
+        graph.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+static void BM_GetEdge(benchmark::State &state)
+{
+    Dataset &data = dataset(state.range(0));
+    CollabGraph graph;
+    buildGraph(data.artists, graph);
+
+    vector<Collaboration> edges = collaborations(data);
+    if (edges.empty()) {
+        state.SkipWithError("dataset has no collaborations");
+        return;
+    }
+
+    size_t next = 0;
+    for (auto _ : state) {
+        const Collaboration &edge = edges[next];
+        benchmark::DoNotOptimize(
+            graph.get_edge(*edge.first.first, *edge.first.second));
+        next = (next + 7919) % edges.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void findVertex(benchmark::State &state, bool known)
+{
+    Dataset &data = dataset(state.range(0));
+    CollabGraph graph;
+    buildGraph(data.artists, graph);
+    CompactGraph compact(graph);
+
+    vector<string> names;
+    for (const unique_ptr<Artist> &artist : data.artists) {
+        names.push_back(artist->get_name() + (known ? "" : " (live)"));
+    }
+
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(compact.find_vertex(names[next]));
+        next = (next + 7919) % names.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_FindHit(benchmark::State &state)  { findVertex(state, true); }
+static void BM_FindMiss(benchmark::State &state) { findVertex(state, false); }
+
+enum class Query { BFS, DFS, NOT };
+
+static void runQueries(benchmark::State &state, Query query)
+{
+    Dataset &data = dataset(state.range(0));
+    SixDegrees &sixDegrees = populated(state.range(0));
+    vector<pair<Artist, Artist>> pairs = randomPairs(data, QUERY_PAIRS, 1);
+    vector<pair<Artist, Artist>> avoid = randomPairs(data, QUERY_PAIRS, 2);
+
+    size_t next = 0;
+    vector<Artist> notList;
+    for (auto _ : state) {
+        const pair<Artist, Artist> &ends = pairs[next];
+        switch (query) {
+            case Query::BFS:
+                sixDegrees.bfs_function(ends.first, ends.second);
+                break;
+            case Query::DFS:
+                sixDegrees.dfs_function(ends.first, ends.second);
+                break;
+            case Query::NOT:
+                notList.assign({ avoid[next].first, avoid[next].second });
+                sixDegrees.not_function(ends.first, ends.second, notList);
+                break;
+        }
+        next = (next + 1) % pairs.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_Bfs(benchmark::State &state) { runQueries(state, Query::BFS); }
+static void BM_Dfs(benchmark::State &state) { runQueries(state, Query::DFS); }
+static void BM_Not(benchmark::State &state) { runQueries(state, Query::NOT); }
+
+int main(int argc, char *argv[])
+{
+    size_t maxArtists = 100000;
+    int kept = 1;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.compare(0, 14, "--max-artists=") == 0) {
+            if (not parseCount(arg.substr(14), maxArtists) or
+                maxArtists < 1000) {
+                cerr << "Usage: ./suite_bench [--max-artists=N] "
+                     << "[Google Benchmark flags]\n"
+                     << "       N is a whole number, at least 1000"
+                     << endl;
+                return 1;
+            }
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+
+    vector<size_t> sizes;
+    for (size_t n = 1000; n <= maxArtists and n <= 10000000; n *= 10) {
+        sizes.push_back(n);
+    }
+    for (size_t n : { size_t(1000), SET_EDGES_MAX }) {
+        if (n <= maxArtists) {
+            benchmark::RegisterBenchmark("SetEdges", BM_SetEdges)
+                ->Arg(n)->Unit(benchmark::kMillisecond);
+        }
+    }
+
+    for (size_t n : sizes) {
+        benchmark::RegisterBenchmark("ReadArtists", BM_ReadArtists)
+            ->Arg(n)->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark("Populate", BM_Populate)
+            ->Arg(n)->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark("InsertEdge", BM_InsertEdge)
+            ->Arg(n)->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark("GetEdge", BM_GetEdge)->Arg(n);
+        benchmark::RegisterBenchmark("FindVertex/Hit", BM_FindHit)->Arg(n);
+        benchmark::RegisterBenchmark("FindVertex/Miss", BM_FindMiss)->Arg(n);
+        benchmark::RegisterBenchmark("Bfs", BM_Bfs)
+            ->Arg(n)->Unit(benchmark::kMicrosecond);
+        benchmark::RegisterBenchmark("Dfs", BM_Dfs)
+            ->Arg(n)->Unit(benchmark::kMicrosecond);
+        benchmark::RegisterBenchmark("Not", BM_Not)
+            ->Arg(n)->Unit(benchmark::kMicrosecond);
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * Synthetic.cpp
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Power-law synthetic dataFiles for the benchmarks.
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Synthetic.h"
+#include "DataLoader.h"
+
+using namespace std;
+
+/*
+ * @function: drawDiscography
+ * @purpose: Picks the songs of one artist.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: 'songs' holds distinct song ids, in the order they
+ * were drawn.
+ *
+ * @parameters: spec - The dataset shape (const SyntheticSpec&),
+ * rng - The random source (mt19937_64&), songs - Filled with the
+ * artist's songs (vector<uint64_t>&).
+ *
+ * @returns: None.
+ */
+
+static void drawDiscography(const SyntheticSpec &spec, mt19937_64 &rng,
+                            vector<uint64_t> &songs)
+{
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    uint64_t pool = max<uint64_t>(1, spec.artists * spec.songsPerArtist);
+
+    /* Pareto with minimum 1: most artists have one song, a few many */
+    double u = 1.0 - unit(rng);
+    size_t count = static_cast<size_t>(pow(u, -1.0 / spec.shape));
+    count = min(max<size_t>(count, 1), spec.maxSongs);
+    count = min<uint64_t>(count, pool);
+
+    songs.clear();
+    uniform_int_distribution<uint64_t> pick(0, pool - 1);
+    while (songs.size() < count) {
+        uint64_t song = pick(rng);
+        if (find(songs.begin(), songs.end(), song) == songs.end()) {
+            songs.push_back(song);
+        }
+    }
+}
+
+/*
+ * @function: syntheticName
+ * @purpose: Names a synthetic artist.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: artist - The artist's number (size_t).
+ *
+ * @returns: The artist's name (string).
+ */
+
+string syntheticName(size_t artist)
+{
+    return "Artist " + to_string(artist);
+}
+
+/*
+ * @function: writeSynthetic
+ * @purpose: Writes a synthetic dataFile in the '*'-delimited format.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: 'out' holds spec.artists artists, each followed by
+ * its songs and a "*" line. The same spec always gives the same file.
+ *
+ * @parameters: out - Where to write (ostream&), spec - The dataset
+ * shape (const SyntheticSpec&).
+ *
+ * @returns: None.
+ */
+
+void writeSynthetic(ostream &out, const SyntheticSpec &spec)
+{
+    mt19937_64 rng(spec.seed);
+    vector<uint64_t> songs;
+
+    for (size_t a = 0; a < spec.artists; a++) {
+        drawDiscography(spec, rng, songs);
+        out << syntheticName(a) << "\n";
+        for (uint64_t song : songs) {
+            out << "Song " << song << "\n";
+        }
+        out << "*\n";
+    }
+}
+
+/*
+ * @function: makeSynthetic
+ * @purpose: Generates a synthetic dataset and parses it, as main does
+ * with a dataFile.
+ *
+ * @preconditions: None.
+ *
+ * @postconditions: None.
+ *
+ * @parameters: spec - The dataset shape (const SyntheticSpec&).
+ *
+ * @returns: The artists (vector<unique_ptr<Artist>>).
+ */
+
+vector<unique_ptr<Artist>> makeSynthetic(const SyntheticSpec &spec)
+{
+    stringstream text;
+    writeSynthetic(text, spec);
+
+    vector<unique_ptr<Artist>> artists;
+    readArtists(text, artists);
+    return artists;
+}
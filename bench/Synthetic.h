@@ -0,0 +1,41 @@
+/*
+ * Synthetic.h
+ *
+ * CS 15 Project 2: Six Degrees of Collaboration
+ *
+ * Purpose:
+ *   Generates synthetic dataFiles with a power-law collaboration
+ *   structure. Each artist's discography size follows a Pareto
+ *   distribution and its songs are drawn at random from a shared pool,
+ *   so the number of collaborators is heavy-tailed too: a handful of
+ *   artists collaborate with hundreds of others and most with a few.
+ *   The number of collaborations grows linearly with the number of
+ *   artists. Artists are written one at a time, so even 10M-artist
+ *   files are generated in constant memory.
+ */
+#ifndef __SYNTHETIC__
+#define __SYNTHETIC__
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Artist.h"
+
+struct SyntheticSpec {
+    size_t   artists        = 1000;
+    uint64_t seed           = 1;
+    double   songsPerArtist = 1.0;  /* size of the song pool per artist */
+    double   shape          = 1.5;  /* Pareto shape of discography sizes */
+    size_t   maxSongs       = 256;  /* cap on one discography */
+};
+
+void writeSynthetic(std::ostream &out, const SyntheticSpec &spec);
+
+std::vector<std::unique_ptr<Artist>> makeSynthetic(const SyntheticSpec &spec);
+
+std::string syntheticName(size_t artist);
+
+#endif /* __SYNTHETIC__ */
@@ -6,35 +6,259 @@
  * by Iman Enayati, April 18th 2024
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <cstring>
 #include <vector>
 #include <memory>
+#include <thread>
+#include <utility>
 
+#include <pthread.h>
+#include <signal.h>
+
+#include "AllocStats.h"
 #include "Artist.h"
 #include "CollabGraph.h"
 #include "SixDegrees.h"
+#include "DataLoader.h"
+#include "QueryMetrics.h"
+#include "QueryRunner.h"
+#include "Parallel.h"
+#include "ShardedSearch.h"
 
 using namespace std;
 
-void handleLine(string line, 
+struct Options {
+    SearchBudget budget;
+    VertexOrder order = VertexOrder::INSERTION;
+    bool compress = false;
+    bool bipartite = false;
+    bool allocStats = false;
+    bool metrics = false;
+    bool profileLoad = false;
+    size_t threads = 0;
+    size_t jobs = 1;
+    bool async = false;
+    bool foldNames = false;
+    size_t suggestions = 0;
+    size_t streamBatch = 0;      /* artists per first batch; 0 loads all */
+    size_t partition = 0;        /* shards to write; 0 runs commands */
+    bool shards = false;         /* files[0] is a shard prefix */
+    string metricsFile;
+    vector<string> files;
+};
+
+/*
+ * @function: parseCount
+ * @purpose: Reads a non-negative whole number.
+ *
+ * @parameters: text - The text to read (const string&), count - Set
+ * to the number read (size_t&).
+ *
+ * @returns: True iff 'text' is made up only of digits.
+ */
+
+bool parseCount(const string &text, size_t &count)
+{
+    if (text.empty() or text.size() > 18) {
+        return false;
+    }
+    count = 0;
+    for (char c : text) {
+        if (c < '0' or c > '9') {
+            return false;
+        }
+        count = count * 10 + (c - '0');
+    }
+    return true;
+}
+
+/*
+ * @function: parseOptions
+ * @purpose: Splits the command line into --options and file names.
+ *
+ * @parameters: argc, argv - The command line, options - Filled in
+ * from the command line (Options&).
+ *
+ * @returns: True iff every option was recognized and well formed.
+ */
+
+bool parseOptions(int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.compare(0, 2, "--") != 0) {
+            options.files.push_back(arg);
+        } else if (arg.compare(0, 13, "--max-visits=") == 0) {
+            if (not parseCount(arg.substr(13), options.budget.maxVisits)) {
+                return false;
+            }
+        } else if (arg.compare(0, 12, "--max-depth=") == 0) {
+            if (not parseCount(arg.substr(12), options.budget.maxDepth)) {
+                return false;
+            }
+        } else if (arg == "--compress") {
+            options.compress = true;
+        } else if (arg == "--bipartite") {
+            options.bipartite = true;
+        } else if (arg == "--alloc-stats") {
+            options.allocStats = true;
+        } else if (arg.compare(0, 10, "--threads=") == 0) {
+            if (not parseCount(arg.substr(10), options.threads)) {
+                return false;
+            }
+        } else if (arg.compare(0, 7, "--jobs=") == 0) {
+            if (not parseCount(arg.substr(7), options.jobs)) {
+                return false;
+            }
+        } else if (arg == "--async") {
+            options.async = true;
+        } else if (arg.compare(0, 11, "--deadline=") == 0) {
+            if (not parseCount(arg.substr(11), options.budget.deadlineMs)) {
+                return false;
+            }
+        } else if (arg == "--fold-names") {
+            options.foldNames = true;
+        } else if (arg == "--suggest") {
+            options.suggestions = 3;
+        } else if (arg.compare(0, 10, "--suggest=") == 0) {
+            if (not parseCount(arg.substr(10), options.suggestions)) {
+                return false;
+            }
+        } else if (arg == "--stream") {
+            options.streamBatch = 1000;
+        } else if (arg.compare(0, 9, "--stream=") == 0) {
+            if (not parseCount(arg.substr(9), options.streamBatch) or
+                options.streamBatch == 0) {
+                return false;
+            }
+        } else if (arg.compare(0, 12, "--partition=") == 0) {
+            if (not parseCount(arg.substr(12), options.partition) or
+                options.partition == 0) {
+                return false;
+            }
+        } else if (arg == "--shards") {
+            options.shards = true;
+        } else if (arg == "--profile-load") {
+            options.profileLoad = true;
+        } else if (arg == "--metrics") {
+            options.metrics = true;
+        } else if (arg.compare(0, 10, "--metrics=") == 0) {
+            options.metrics = true;
+            options.metricsFile = arg.substr(10);
+        } else if (arg.compare(0, 10, "--reorder=") == 0) {
+            if (not parse_vertex_order(arg.substr(10), options.order)) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    /* reordering and compression apply to pairwise adjacency lists */
+    if (options.bipartite and
+        (options.compress or options.order != VertexOrder::INSERTION)) {
+        return false;
+    }
+    /* --partition takes a dataFile and the prefix of the shard files;
+     * --shards runs commands on shard files instead of a dataFile */
+    if (options.partition != 0) {
+        return options.files.size() == 2 and not options.shards and
+               options.streamBatch == 0;
+    }
+    if (options.shards and options.streamBatch != 0) {
+        return false;
+    }
+    /* the shard workers search without budgets and record no metrics */
+    if (options.shards and
+        (options.budget.maxVisits != 0 or options.budget.maxDepth != 0 or
+         options.budget.deadlineMs != 0 or options.metrics)) {
+        return false;
+    }
+    return options.files.size() >= 1 and options.files.size() <= 3;
+}
+
+/*
+ * @function: handleLine
+ * @purpose: Feeds one line of input to the command being built, and
+ * submits the command once it is complete. "cancel", between
+ * commands, stops the queries still running instead. "reload",
+ * "export" and "dump" take just a file name on the line after them.
+ *
+ * @parameters: line - The input line (string), commands, notList -
+ * The command built so far (the lines of the list that not, through
+ * and avoid end with "*"; mbfs keeps its sources in 'commands' and
+ * its targets in 'notList'), runner - Runs the command (QueryRunner&).
+ *
+ * @returns: False iff the line was "quit".
+ */
+
+bool handleLine(string line, 
                 vector<string> &commands, 
-                vector<unique_ptr<Artist>> &notList,
-                unique_ptr<SixDegrees> &sixDegrees)
+                vector<string> &notList,
+                QueryRunner &runner)
 {
     if (line == "quit") {
-        exit(0);
+        return false;
+    }
+    if (commands.empty() and line == "cancel") {
+        runner.cancel();
+        return true;
+    }
+
+    if (not commands.empty() and
+        (commands.front() == "reload" or commands.front() == "export" or
+         commands.front() == "dump")) {
+        Query query;
+        query.command = commands.front();
+        query.dataFile = line;
+        runner.submit(move(query));
+        commands.clear();
+        return true;
+    }
+
+    /* mbfs: sources, "*", targets, "*"; a "*" after the sources in
+     * 'commands' marks that the targets have begun */
+    if (not commands.empty() and commands.front() == "mbfs") {
+        if (line != "*") {
+            (commands.back() == "*" ? notList : commands).push_back(line);
+            return true;
+        }
+        if (commands.back() != "*") {
+            commands.push_back(line);
+            return true;
+        }
+
+        Query query;
+        query.command = "mbfs";
+        for (size_t i = 1; i + 1 < commands.size(); i++) {
+            query.sources.push_back(Artist(commands[i]));
+        }
+        for (const string &listed : notList) {
+            query.targets.push_back(Artist(listed));
+        }
+        runner.submit(move(query));
+        commands.clear();
+        notList.clear();
+        return true;
     }
 
     bool skipNot = false;
     if (commands.size() < 3) {
         if (
         commands.size() == 0 && !(
-        line == "bfs" || line == "dfs" || line == "not")) {
-*(sixDegrees->output) << line << " is not a command. Please try again." << endl;
-        return;
+        line == "bfs" || line == "dfs" || line == "not" ||
+        line == "within" || line == "through" || line == "avoid" ||
+        line == "mbfs" || line == "matrix" || line == "reload" ||
+        line == "export" || line == "dump")) {
+            Query message;
+            message.message = line + " is not a command. Please try again.\n";
+            runner.submit(move(message));
+            return true;
         }
         if (commands.size() == 2) {
             skipNot = true;
@@ -43,114 +267,306 @@ void handleLine(string line,
     }
 
     if (commands.size() != 3) {
-        return;
+        return true;
     }
 
-    Artist s = Artist(commands[1]);
-    Artist f = Artist(commands[2]);
+    Query query;
+    query.command = commands.front();
+    query.from = Artist(commands[1]);
+    query.to = Artist(commands[2]);
 
-    if (commands.front() == "bfs") {
-        sixDegrees->clear_metadata(); 
-        sixDegrees->bfs_function(s, f);
+    if (commands.front() == "bfs" or commands.front() == "dfs") {
+        runner.submit(move(query));
         commands.clear();
-        return;
+        return true;
     }
 
-    if (commands.front() == "dfs") {
-        sixDegrees->clear_metadata(); 
-        sixDegrees->dfs_function(s, f);
+    if (commands.front() == "matrix") {
+        query.listFile = commands[1];
+        query.matrixFile = commands[2];
+        runner.submit(move(query));
         commands.clear();
-        return;
+        return true;
+    }
+
+    if (commands.front() == "within") {
+        if (not parseCount(commands[2], query.degrees)) {
+            query.command.clear();
+            query.message = "\"" + commands[2] + "\"" +
+                            " is not a valid number of degrees.\n";
+        }
+        runner.submit(move(query));
+        commands.clear();
+        return true;
     }
 
     if (line == "*") {
-        vector<Artist> plainNotList;
-        for (auto &uniqueArt : notList) {
-            plainNotList.push_back(*uniqueArt);
+        for (const string &listed : notList) {
+            if (query.command == "not") {
+                query.avoid.push_back(Artist(listed));
+            } else {
+                query.songs.push_back(listed);
+            }
         }
-        sixDegrees->not_function(s, f, plainNotList);
+        runner.submit(move(query));
         commands.clear();
         notList.clear();
-        return;
+        return true;
     } else {
         if (!skipNot) {
-            notList.push_back(make_unique<Artist>(line));
+            notList.push_back(line);
+        }
+    }
+    return true;
+}
+
+/*
+ * @function: loadArtists
+ * @purpose: Reads the dataFile into the graph, all at once or, with
+ * --stream, a batch at a time while queries are already running.
+ *
+ * @parameters: dataFile - The open dataFile (istream&), artistList -
+ * Owns the artists read (vector<unique_ptr<Artist>>&), sixDegree -
+ * The graph to load (SixDegrees&), options - The batch size and
+ * whether to profile (const Options&), stop - Set once no more
+ * queries will come (const atomic<bool>&).
+ *
+ * @returns: None.
+ *
+ * @notes: After each batch the graph is rebuilt from every artist
+ * read so far and published as a new version. Each batch is at least
+ * as large as everything before it, so the rebuilds together cost
+ * at most about twice one full build. Under --profile-load every
+ * version's profile is printed. Loading gives up if a reload
+ * publishes a version in between, so it never replaces the
+ * reloaded dataset with this one. The graphs keep only names and
+ * pooled song titles, so once loading ends the artists read, and
+ * their discographies, are freed.
+ */
+
+void loadArtists(istream &dataFile, vector<unique_ptr<Artist>> &artistList,
+                 SixDegrees &sixDegree, const Options &options,
+                 const atomic<bool> &stop)
+{
+    vector<Artist*> rawList;
+    LoadProfile profile;
+    do {
+        size_t batch = options.streamBatch == 0
+                     ? 0 : max(options.streamBatch, artistList.size());
+        auto start = chrono::steady_clock::now();
+        profile.bytesRead += readArtists(dataFile, artistList, batch);
+        profile.parseMs = chrono::duration<double, milli>(
+                              chrono::steady_clock::now() - start).count();
+        if (artistList.size() == rawList.size() and not rawList.empty()) {
+            break;
+        }
+
+        for (size_t i = rawList.size(); i < artistList.size(); i++) {
+            rawList.push_back(artistList[i].get());
+        }
+        size_t version = sixDegree.populateGraph(rawList);
+
+        if (options.profileLoad) {
+            sixDegree.profileLoad(profile);
+            profile.peakRssBytes = peakRssBytes();
+            printLoadProfile(cerr, profile);
+        }
+        if (sixDegree.snapshot()->version != version) {
+            break;
+        }
+    } while (dataFile and not stop);
+
+    rawList.clear();
+    artistList.clear();
+    artistList.shrink_to_fit();
+}
+
+/*
+ * @function: reloadOnSignal
+ * @purpose: Reloads the dataFile each time the process gets SIGHUP,
+ * or says reload is not available if the graph is sharded.
+ *
+ * @parameters: sixDegree - The graph to reload (SixDegrees&),
+ * dataFile - The file to reload from (const string&), stop - Set,
+ * before a last SIGHUP, once no more queries will come
+ * (const atomic<bool>&).
+ *
+ * @returns: None.
+ *
+ * @notes: SIGHUP must be blocked in every thread, so that it is only
+ * ever taken here by sigwait and never interrupts a query. The
+ * result goes to std::cerr, since it answers no command.
+ */
+
+void reloadOnSignal(SixDegrees &sixDegree, const string &dataFile,
+                    const atomic<bool> &stop)
+{
+    sigset_t hangup;
+    sigemptyset(&hangup);
+    sigaddset(&hangup, SIGHUP);
+    int received;
+    while (sigwait(&hangup, &received) == 0 and not stop) {
+        if (sixDegree.sharded()) {
+            cerr << "reload is not available with --shards." << endl;
+        } else {
+            sixDegree.reload_function(dataFile, cerr);
         }
     }
 }
 
 int main(int argc, char *argv[])
 {
-    if (argc < 2 || argc > 4) {
-        cerr<<"Usage: ./SixDegrees dataFile [commandFile] [outputFile]"<<endl;
+    Options options;
+    if (not parseOptions(argc, argv, options)) {
+        cerr << "Usage: ./SixDegrees [--max-visits=N] [--max-depth=N] "
+             << "[--deadline=MS]\n"
+             << "       [--reorder=insertion|bfs|rcm|degree]\n"
+             << "       [--compress | --bipartite] [--alloc-stats] "
+             << "[--metrics[=file]] [--profile-load]\n"
+             << "       [--threads=N] [--jobs=N] [--async] "
+             << "[--fold-names] [--suggest[=K]]\n"
+             << "       [--stream[=N]]\n"
+             << "       dataFile [commandFile] [outputFile]\n"
+             << "   or: ./SixDegrees [--reorder=...] [--compress | "
+             << "--bipartite] --partition=N\n"
+             << "       dataFile shardPrefix\n"
+             << "   or: ./SixDegrees --shards [--jobs=N] [--async] "
+             << "shardPrefix [commandFile] [outputFile]"
+             << endl;
+        exit(0);
+    }
+    if (options.allocStats and not allocation_counting()) {
+        cerr << "Error: --alloc-stats needs a build made with "
+             << "\"make ALLOC_STATS=1\"" << endl;
         exit(0);
     }
 
-    ifstream dataFile(argv[1]);
+    /* before any thread starts, so all of them inherit the mask */
+    sigset_t hangup;
+    sigemptyset(&hangup);
+    sigaddset(&hangup, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &hangup, nullptr);
+
+    ifstream dataFile;
+    if (not options.shards) {
+        dataFile.open(options.files[0]);
+    }
     string line;
     vector<unique_ptr<Artist>> artistList;
     unique_ptr<SixDegrees> sixDegree = make_unique<SixDegrees>();
+    atomic<bool> stopLoading(false);
+    thread loader;
+    unique_ptr<ShardCoordinator> coordinator;
 
-    if (dataFile.is_open()) {
-        unique_ptr<Artist> curArtist;
-        bool nameSet = false;
-        while (getline(dataFile, line)) {
-            if (line != "*") {
-                if (!nameSet) {
-                    curArtist = make_unique<Artist>();
-                    curArtist->set_name(line);
-                    nameSet = true;
-                } else {
-                    curArtist->add_song(line);
-                }
-            } else {
-                nameSet = false;
-                artistList.push_back(std::move(curArtist));
-                curArtist = make_unique<Artist>();
-            }
+    /* the workers are forked here, before any other thread starts */
+    if (options.shards) {
+        coordinator = ShardCoordinator::open(options.files[0]);
+        if (coordinator == nullptr) {
+            cerr << "Error: could not start the shards in "
+                 << options.files[0] << endl;
+            exit(0);
         }
-        if (nameSet) {
-            artistList.push_back(std::move(curArtist));
+        sixDegree->configureShards(coordinator.get());
+    } else if (dataFile.is_open()) {
+        sixDegree->configureOrder(options.order);
+        sixDegree->configureCompression(options.compress);
+        sixDegree->configureBipartite(options.bipartite);
+        sixDegree->configureThreads(options.threads);
+        sixDegree->configureLookup(options.foldNames, options.suggestions);
+        sixDegree->configureBudget(options.budget);
+
+        /* queries start on the empty graph; each batch loaded
+         * publishes a larger one */
+        if (options.streamBatch != 0) {
+            loader = thread(loadArtists, ref(dataFile), ref(artistList),
+                            ref(*sixDegree), cref(options),
+                            cref(stopLoading));
+        } else {
+            loadArtists(dataFile, artistList, *sixDegree, options,
+                        stopLoading);
         }
 
-        vector<Artist*> rawList;
-        for (auto &artPtr : artistList) {
-            rawList.push_back(artPtr.get());
+        if (options.partition != 0) {
+            SnapshotPtr snap = sixDegree->snapshot();
+            if (not write_shards(*snap->graph, options.partition,
+                                 options.files[1])) {
+                cerr << "Error: could not write the shards to "
+                     << options.files[1] << endl;
+                exit(0);
+            }
+            cout << "Wrote " << snap->graph->vertex_count()
+                 << " artists to " << options.partition << " shards in "
+                 << options.files[1] << "." << endl;
+            return 0;
         }
-        sixDegree->populateGraph(rawList);
 
     } else {
-        cerr << "Error: could not open file " << argv[1] << endl;
+        cerr << "Error: could not open file " << options.files[0] << endl;
         exit(0);
     }
 
     ofstream outputFile;
-    if (argc == 4) {
-        outputFile.open(argv[3]);
+    if (options.files.size() == 3) {
+        outputFile.open(options.files[2]);
         sixDegree->configureOutput(&outputFile);
     }
 
+    ofstream metricsFile;
+    unique_ptr<QueryMetrics> metrics;
+    if (options.metrics) {
+        ostream *metricsOut = &cerr;
+        if (not options.metricsFile.empty()) {
+            metricsFile.open(options.metricsFile);
+            metricsOut = &metricsFile;
+        }
+        metrics = make_unique<QueryMetrics>(*metricsOut);
+        sixDegree->configureMetrics(metrics.get());
+    }
+
     vector<string> commands;
-    vector<unique_ptr<Artist>> notList;
+    vector<string> notList;
+    /* --async needs a worker to leave the reader free */
+    size_t jobs = options.jobs == 0 ? default_threads() : options.jobs;
+    if (options.async) {
+        jobs = max<size_t>(jobs, 2);
+    }
+    QueryRunner runner(*sixDegree, jobs, options.allocStats,
+                       not options.async);
+    atomic<bool> stopReloading(false);
+    thread reloader(reloadOnSignal, ref(*sixDegree), cref(options.files[0]),
+                    cref(stopReloading));
 
-    if (argc >= 3) {
-        ifstream commandFile(argv[2]);
+    if (options.files.size() >= 2) {
+        ifstream commandFile(options.files[1]);
         if (commandFile.is_open()) {
-            while (getline(commandFile, line)) {
-                handleLine(line, commands, notList, sixDegree);
+            while (getline(commandFile, line) and
+                   handleLine(line, commands, notList, runner)) {
             }
             commandFile.close();
         } else {
-            cerr << "Error: could not open file " << argv[2] << endl;
+            cerr << "Error: could not open file " << options.files[1] << endl;
             exit(0);
         }
 
     } else {
-        while (getline(cin, line)) {
-            handleLine(line, commands, notList, sixDegree);
+        while (getline(cin, line) and
+               handleLine(line, commands, notList, runner)) {
         }
     }
-    
+    runner.finish();
+    stopLoading = true;
+    if (loader.joinable()) {
+        loader.join();
+    }
+    if (reloader.joinable()) {
+        stopReloading = true;
+        pthread_kill(reloader.native_handle(), SIGHUP);
+        reloader.join();
+    }
+
+    if (metrics != nullptr) {
+        metrics->report();
+    }
     outputFile.close();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,139 @@
+#!/bin/sh
+#
+# run_tests.sh
+#
+# CS 15 Project 2: Six Degrees of Collaboration
+#
+# Purpose:
+#   Regression tests, run by "make test". Each case runs
+#   NAME_commands.txt over artists.txt with the flags given below and
+#   compares what SixDegrees prints with NAME_expected.txt, and the
+#   files a command writes with their expected copies. Many cases run
+#   again with other layouts or --jobs, which must print exactly the
+#   same. The cases run in a scratch directory, so the command files
+#   name their inputs and outputs without a path.
+#
+
+tests=$(cd "$(dirname "$0")" && pwd)
+program=$tests/../SixDegrees
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+cp "$tests"/*.txt "$tests"/*.csv "$work"
+cd "$work" || exit 1
+
+passed=0
+failed=0
+
+# result DESCRIPTION STATUS: counts a case, printing it if it failed
+result() {
+    if [ "$2" -eq 0 ]; then
+        passed=$((passed + 1))
+    else
+        failed=$((failed + 1))
+        echo "FAILED: $1"
+    fi
+}
+
+# check_as NAME EXPECTED FLAGS...: NAME_commands.txt must print
+# EXPECTED_expected.txt
+check_as() {
+    name=$1
+    expected=$2
+    shift 2
+    rm -f out.txt
+    "$program" "$@" artists.txt "${name}_commands.txt" out.txt 2>/dev/null
+    cmp -s out.txt "${expected}_expected.txt"
+    result "$name $*" $?
+}
+
+# check NAME FLAGS...: NAME_commands.txt must print NAME_expected.txt
+check() {
+    check_as "$1" "$@"
+}
+
+# check_file FILE EXPECTED: the file the last case wrote
+check_file() {
+    cmp -s "$1" "$2"
+    result "$1" $?
+}
+
+# same NAME FLAGS...: NAME_commands.txt prints the same with FLAGS as
+# with one job, even where no expected output is kept
+same() {
+    name=$1
+    shift
+    rm -f one.txt out.txt
+    "$program" artists.txt "${name}_commands.txt" one.txt 2>/dev/null
+    "$program" "$@" artists.txt "${name}_commands.txt" out.txt 2>/dev/null
+    cmp -s one.txt out.txt
+    result "$name $* against one job" $?
+}
+
+# the path queries, in every layout and with a worker pool
+for flags in "" --compress --reorder=rcm "--reorder=degree --compress" \
+             --bipartite --jobs=4 --deadline=60000; do
+    check paths $flags
+    check within $flags
+    check songs $flags
+    check mbfs $flags
+done
+check budget
+check budget --deadline=60000
+check_as budget budget_depth --max-depth=2
+check_as budget budget_visits --max-visits=3
+
+# commands that write files
+for flags in "" --bipartite --threads=3; do
+    rm -f matrix.csv
+    check matrix $flags
+    check_file matrix.csv matrix_expected.csv
+done
+for flags in "" --threads=3 --jobs=4; do
+    rm -f dump.txt export.bin
+    check files $flags
+    check_file dump.txt dump_expected.txt
+    test -s export.bin
+    result "export.bin $flags" $?
+done
+
+# cancel only has something left to stop with more than one job
+check cancel
+
+# a reload is a barrier: the queries after it see the new graph, and
+# the output is the same for any number of jobs
+for flags in "" --jobs=2 --jobs=4 --jobs=16 --async "--async --jobs=4"; do
+    check reload $flags
+    same reload $flags
+done
+
+# queries start on the empty graph while --stream loads, so only
+# those after a reload, which stops the loader, print the same each
+# time
+check stream --stream=2
+check stream --stream=2 --jobs=4
+
+# --shards answers bfs and not from worker processes
+rm -f shard.*
+"$program" --partition=3 artists.txt shard >/dev/null
+result "--partition=3" $?
+for flags in "" --jobs=4; do
+    rm -f out.txt
+    "$program" --shards $flags shard shards_commands.txt out.txt 2>/dev/null
+    cmp -s out.txt shards_expected.txt
+    result "shards $flags" $?
+done
+rm -f out.txt
+"$program" --shards --max-depth=2 shard shards_commands.txt out.txt \
+    2>/dev/null
+test ! -e out.txt
+result "--shards refuses --max-depth" $?
+
+# --metrics: everything but the times
+rm -f metrics.jsonl
+check paths --metrics=metrics.jsonl
+grep -v '"histogram":"\(search\|print\)_us"' metrics.jsonl |
+    sed 's/,"search_us":.*}$/}/' > metrics.txt
+check_file metrics.txt metrics_expected.txt
+
+echo "$passed passed, $failed failed"
+[ "$failed" -eq 0 ]